@@ -0,0 +1,297 @@
+#include "aggregate_engine.hpp"
+#include "schema.hpp"
+#include "row_view.hpp"
+#include "table_scan.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    enum class AggFunc { Count, Sum, Min, Max, Avg };
+
+    struct AggSpec {
+        AggFunc     func;
+        int         col;    // -1 for COUNT(*)
+        std::string label;  // as typed by the user, used as output header
+    };
+
+    struct Accumulator {
+        long long count = 0;
+        long long sum = 0;
+        long long min = std::numeric_limits<long long>::max();
+        long long max = std::numeric_limits<long long>::min();
+    };
+
+    constexpr int FIELD_SIZE = Schema::FIELD_SIZE;
+    // key of the single group of a query without GROUP BY
+    const char NO_KEY[FIELD_SIZE] = {};
+
+    uint64_t hashKey(const char* key, size_t len) {
+        uint64_t h = 1469598103934665603ULL;  // FNV-1a
+        for (size_t i = 0; i < len; ++i) {
+            h ^= (unsigned char)key[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    long long parseInt(const char* p) {
+        long long v = 0;
+        std::from_chars(p, p + strnlen(p, FIELD_SIZE), v);
+        return v;
+    }
+
+    /// Open-addressing (linear probing) map from group key to a row of
+    /// accumulators. Keys and accumulators live in flat arrays indexed by
+    /// group number; the probe array only stores group numbers.
+    class GroupTable {
+    public:
+        explicit GroupTable(size_t aggCount) : aggs(aggCount), slots(64, -1) {}
+
+        /// Return the group number for key, inserting a new group if needed
+        int32_t findOrInsert(const char* key, size_t len, uint64_t h) {
+            size_t mask = slots.size() - 1;
+            for (size_t s = h & mask;; s = (s + 1) & mask) {
+                int32_t g = slots[s];
+                if (g < 0) {
+                    g = (int32_t)hashes.size();
+                    slots[s] = g;
+                    hashes.push_back(h);
+                    keys.resize(keys.size() + FIELD_SIZE, 0);
+                    std::memcpy(keys.data() + (size_t)g * FIELD_SIZE, key, len);
+                    accs.resize(accs.size() + aggs);
+                    if (hashes.size() * 2 > slots.size()) grow();
+                    return g;
+                }
+                if (hashes[g] == h && std::memcmp(keys.data() + (size_t)g * FIELD_SIZE, key, len) == 0
+                    && (len == FIELD_SIZE || keys[(size_t)g * FIELD_SIZE + len] == '\0')) {
+                    return g;
+                }
+            }
+        }
+
+        size_t groupCount() const { return hashes.size(); }
+        const char* key(int32_t g) const { return keys.data() + (size_t)g * FIELD_SIZE; }
+        uint64_t hash(int32_t g) const { return hashes[g]; }
+        Accumulator* row(int32_t g) { return accs.data() + (size_t)g * aggs; }
+
+    private:
+        size_t aggs;
+        std::vector<int32_t> slots;
+        std::vector<uint64_t> hashes;
+        std::vector<char> keys;
+        std::vector<Accumulator> accs;
+
+        void grow() {
+            std::vector<int32_t> bigger(slots.size() * 2, -1);
+            size_t mask = bigger.size() - 1;
+            for (int32_t g = 0; g < (int32_t)hashes.size(); ++g) {
+                size_t s = hashes[g] & mask;
+                while (bigger[s] >= 0) s = (s + 1) & mask;
+                bigger[s] = g;
+            }
+            slots.swap(bigger);
+        }
+    };
+
+    // Per-thread group table plus the column buffers reused by every batch
+    struct Partial {
+        GroupTable table;
+        std::vector<int32_t> groupOf;
+        std::vector<long long> values;
+
+        explicit Partial(size_t aggCount)
+            : table(aggCount), groupOf(AggregateEngine::BATCH_ROWS),
+            values(AggregateEngine::BATCH_ROWS) {}
+    };
+
+    // Aggregate n consecutive rows into the thread's partial table
+    void aggregateBatch(const char* rows, int n, int rowSize, int groupCol,
+        const std::vector<AggSpec>& specs, Partial& part) {
+        // 1) resolve the group of every row in the batch; without GROUP BY
+        //    every row falls in the one global group, looked up once
+        if (groupCol < 0) {
+            std::fill_n(part.groupOf.begin(), n, part.table.findOrInsert(NO_KEY, 0, 0));
+        }
+        for (int i = 0; groupCol >= 0 && i < n; ++i) {
+            std::string_view k = RowView(rows + (size_t)i * rowSize).field(groupCol);
+            part.groupOf[i] = part.table.findOrInsert(k.data(), k.size(), hashKey(k.data(), k.size()));
+        }
+
+        // 2) one tight loop per aggregate over the decoded column
+        for (size_t a = 0; a < specs.size(); ++a) {
+            const AggSpec& spec = specs[a];
+            if (spec.col >= 0) {
+                for (int i = 0; i < n; ++i)
+                    part.values[i] = RowView(rows + (size_t)i * rowSize).asInt(spec.col);
+            }
+            for (int i = 0; i < n; ++i) {
+                Accumulator& acc = part.table.row(part.groupOf[i])[a];
+                acc.count++;
+                if (spec.col < 0) continue;
+                acc.sum += part.values[i];
+                acc.min = std::min(acc.min, part.values[i]);
+                acc.max = std::max(acc.max, part.values[i]);
+            }
+        }
+    }
+
+    bool parseQuery(const std::string& query, const Schema& schema,
+        std::vector<AggSpec>& specs, int& groupCol) {
+        const auto fields = schema.getFields();
+        std::string upper = query;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        std::string aggPart = query;
+        groupCol = -1;
+        size_t gb = upper.find("GROUP BY");
+        if (gb != std::string::npos) {
+            std::string groupName = Utils::trim(query.substr(gb + 8));
+            groupCol = schema.fieldIndex(groupName);
+            if (groupCol < 0) {
+                std::cout << "Group field not in schema: " << groupName << "\n";
+                return false;
+            }
+            aggPart = query.substr(0, gb);
+        }
+
+        for (const auto& item : Utils::split(aggPart, ',')) {
+            size_t open = item.find('('), close = item.rfind(')');
+            if (open == std::string::npos || close == std::string::npos || close < open) {
+                std::cout << "Invalid aggregate: " << item << "\n";
+                return false;
+            }
+            std::string func = Utils::trim(item.substr(0, open));
+            std::string arg = Utils::trim(item.substr(open + 1, close - open - 1));
+            std::transform(func.begin(), func.end(), func.begin(), ::toupper);
+
+            AggSpec spec;
+            spec.label = item;
+            if (func == "COUNT") spec.func = AggFunc::Count;
+            else if (func == "SUM") spec.func = AggFunc::Sum;
+            else if (func == "MIN") spec.func = AggFunc::Min;
+            else if (func == "MAX") spec.func = AggFunc::Max;
+            else if (func == "AVG") spec.func = AggFunc::Avg;
+            else {
+                std::cout << "Unknown aggregate: " << func << "\n";
+                return false;
+            }
+
+            if (arg == "*" && spec.func == AggFunc::Count) {
+                spec.col = -1;
+            }
+            else {
+                spec.col = schema.fieldIndex(arg);
+                if (spec.col < 0) {
+                    std::cout << "Field not in schema: " << arg << "\n";
+                    return false;
+                }
+                if (spec.func != AggFunc::Count && fields[spec.col].type != "int") {
+                    std::cout << func << " needs an int field: " << arg << "\n";
+                    return false;
+                }
+            }
+            specs.push_back(spec);
+        }
+        if (specs.empty()) {
+            std::cout << "No aggregates given\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+void AggregateEngine::runAggregate(const std::string& tableName) {
+    Schema schema = Schema::loadFromFile("Tables/" + tableName + "/meta.txt");
+    const auto& fields = schema.getFields();
+
+    std::cout << "Enter aggregate query (e.g. COUNT(*), SUM(age) GROUP BY officeid): ";
+    std::string query;
+    std::getline(std::cin, query);
+
+    std::vector<AggSpec> specs;
+    int groupCol = -1;
+    if (!parseQuery(query, schema, specs, groupCol)) {
+        return;
+    }
+
+    // 1) split the table into one row range per scan thread
+    const std::string dataPath = "Tables/" + tableName + "/data.tbl";
+    const int rowSize = schema.rowSize();
+    long rowCount = TableScan::rowCount(dataPath, rowSize);
+    unsigned threads = TableScan::threadsFor(rowCount);
+    std::vector<Partial> partials(threads, Partial(specs.size()));
+    TableScan::parallelScan(dataPath, rowSize, rowCount, threads, BATCH_ROWS,
+        [&](unsigned t, long, const char* rows, int n) {
+            aggregateBatch(rows, n, rowSize, groupCol, specs, partials[t]);
+        });
+
+    // 2) merge partial aggregates into the first table
+    GroupTable& result = partials[0].table;
+    for (unsigned t = 1; t < threads; ++t) {
+        GroupTable& part = partials[t].table;
+        for (int32_t g = 0; g < (int32_t)part.groupCount(); ++g) {
+            const char* k = part.key(g);
+            int32_t into = result.findOrInsert(k, strnlen(k, FIELD_SIZE), part.hash(g));
+            for (size_t a = 0; a < specs.size(); ++a) {
+                Accumulator& dst = result.row(into)[a];
+                const Accumulator& src = part.row(g)[a];
+                dst.count += src.count;
+                dst.sum += src.sum;
+                dst.min = std::min(dst.min, src.min);
+                dst.max = std::max(dst.max, src.max);
+            }
+        }
+    }
+
+    // without GROUP BY an empty table is still one group, e.g. COUNT(*) = 0
+    if (groupCol < 0 && result.groupCount() == 0) {
+        result.findOrInsert(NO_KEY, 0, 0);
+    }
+    if (result.groupCount() == 0) {
+        std::cout << "No rows\n";
+        return;
+    }
+
+    // 3) print groups ordered by key (numerically for int group fields)
+    std::vector<int32_t> order(result.groupCount());
+    for (size_t g = 0; g < order.size(); ++g) order[g] = (int32_t)g;
+    if (groupCol >= 0) {
+        bool numeric = fields[groupCol].type == "int";
+        std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+            if (numeric) return parseInt(result.key(a)) < parseInt(result.key(b));
+            return std::strncmp(result.key(a), result.key(b), FIELD_SIZE) < 0;
+            });
+    }
+
+    for (int32_t g : order) {
+        if (groupCol >= 0) {
+            const char* k = result.key(g);
+            std::cout << fields[groupCol].name << ": " << std::string(k, strnlen(k, FIELD_SIZE)) << "  ";
+        }
+        for (size_t a = 0; a < specs.size(); ++a) {
+            const Accumulator& acc = result.row(g)[a];
+            std::cout << specs[a].label << ": ";
+            if (acc.count == 0 && specs[a].func != AggFunc::Count) {
+                std::cout << "NULL  ";  // nothing to sum or compare over
+                continue;
+            }
+            switch (specs[a].func) {
+            case AggFunc::Count: std::cout << acc.count; break;
+            case AggFunc::Sum:   std::cout << acc.sum; break;
+            case AggFunc::Min:   std::cout << acc.min; break;
+            case AggFunc::Max:   std::cout << acc.max; break;
+            case AggFunc::Avg:   std::cout << (double)acc.sum / acc.count; break;
+            }
+            std::cout << "  ";
+        }
+        std::cout << "\n";
+    }
+}
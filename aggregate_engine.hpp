@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+
+/// COUNT/SUM/MIN/MAX/AVG with optional GROUP BY over a table's data.tbl.
+/// The file is split across scan threads; each thread decodes rows in
+/// column batches of BATCH_ROWS and aggregates into its own open-addressing
+/// group table, and the partial tables are merged once all threads finish.
+class AggregateEngine {
+public:
+    /// Rows decoded per column batch
+    static constexpr int BATCH_ROWS = 1024;
+
+    /// Prompt for an aggregate query, e.g. "COUNT(*), AVG(age) GROUP BY officeid"
+    static void runAggregate(const std::string& tableName);
+};
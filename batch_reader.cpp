@@ -0,0 +1,215 @@
+#include "batch_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#ifdef DBMS_USE_IO_URING
+#include <liburing.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Reader threads started on first use and kept for the life of the process,
+    // so a join probing batch after batch does not start threads per batch.
+    class ReadPool {
+    public:
+        static ReadPool& instance() {
+            static ReadPool pool;
+            return pool;
+        }
+
+        unsigned size() const { return (unsigned)threads.size(); }
+
+        // Run work on the calling thread and up to `helpers` pool threads.
+        // work must share its items through a counter, so that any copy
+        // returning means nothing is left to start; unclaimed slots are
+        // then dropped and only copies already running are waited for.
+        void run(size_t helpers, const std::function<void()>& work) {
+            std::lock_guard<std::mutex> one(runMutex);
+            {
+                std::lock_guard<std::mutex> lock(m);
+                job = &work;
+                wanted = (unsigned)std::min<size_t>(helpers, size());
+            }
+            wake.notify_all();
+            work();
+            std::unique_lock<std::mutex> lock(m);
+            wanted = 0;
+            done.wait(lock, [&] { return active == 0; });
+            job = nullptr;
+        }
+
+    private:
+        ReadPool() {
+            unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned t = 1; t < hw; ++t) {
+                threads.emplace_back([this] { loop(); });
+            }
+        }
+
+        ~ReadPool() {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& t : threads) t.join();
+        }
+
+        void loop() {
+            std::unique_lock<std::mutex> lock(m);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || wanted > 0; });
+                if (stopping) return;
+                --wanted;
+                ++active;
+                const std::function<void()>& work = *job;
+                lock.unlock();
+                work();
+                lock.lock();
+                if (--active == 0) done.notify_all();
+            }
+        }
+
+        std::mutex runMutex;        // one batch at a time
+        std::mutex m;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void()>* job = nullptr;
+        unsigned wanted = 0;        // slots of the current job not yet claimed
+        unsigned active = 0;        // pool threads running the current job
+        bool stopping = false;
+        std::vector<std::thread> threads;
+    };
+}
+
+void BatchReader::readRows(const std::string& dataPath,
+    const std::vector<long>& offsets,
+    int rowSize,
+    std::vector<char>& rows) {
+    rows.assign(offsets.size() * rowSize, 0);
+
+    // 1) sorted, distinct offsets of the rows we actually need
+    std::vector<long> sorted;
+    for (long off : offsets) {
+        if (off >= 0) sorted.push_back(off);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.empty()) {
+        return;
+    }
+
+    // 2) coalesce neighbouring rows into larger sequential reads
+    std::vector<Range> ranges;
+    std::vector<size_t> stagingPos(sorted.size());
+    size_t staged = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        long off = sorted[i];
+        if (!ranges.empty()) {
+            Range& last = ranges.back();
+            long end = last.fileOffset + last.length;
+            if (off - end <= GAP_LIMIT && off + rowSize - last.fileOffset <= MAX_READ) {
+                staged += (off + rowSize) - end;
+                last.length = off + rowSize - last.fileOffset;
+                stagingPos[i] = last.bufferPos + (off - last.fileOffset);
+                continue;
+            }
+        }
+        ranges.push_back({ off, rowSize, staged });
+        stagingPos[i] = staged;
+        staged += rowSize;
+    }
+
+    // 3) submit all reads asynchronously
+    std::vector<char> staging(staged, 0);
+    if (!readRangesUring(dataPath, ranges, staging.data())) {
+        readRangesThreaded(dataPath, ranges, staging.data());
+    }
+
+    // 4) hand every caller slot its row
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        if (offsets[i] < 0) continue;
+        size_t s = std::lower_bound(sorted.begin(), sorted.end(), offsets[i]) - sorted.begin();
+        std::memcpy(rows.data() + i * rowSize, staging.data() + stagingPos[s], rowSize);
+    }
+}
+
+#ifdef DBMS_USE_IO_URING
+bool BatchReader::readRangesUring(const std::string& dataPath,
+    const std::vector<Range>& ranges, char* staging) {
+    int fd = open(dataPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    unsigned depth = static_cast<unsigned>(std::min<size_t>(ranges.size(), 64));
+    io_uring ring;
+    if (io_uring_queue_init(depth, &ring, 0) < 0) {
+        close(fd);
+        return false;
+    }
+
+    bool ok = true;
+    size_t next = 0;
+    unsigned inflight = 0;
+    while (next < ranges.size() || inflight > 0) {
+        // keep the submission queue full
+        while (next < ranges.size() && inflight < depth) {
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (!sqe) break;
+            const Range& r = ranges[next];
+            io_uring_prep_read(sqe, fd, staging + r.bufferPos, r.length, r.fileOffset);
+            ++next;
+            ++inflight;
+        }
+        io_uring_submit(&ring);
+
+        io_uring_cqe* cqe;
+        if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+            ok = false;
+            break;
+        }
+        // short reads only happen at EOF and leave the zeroed tail in place
+        if (cqe->res < 0) ok = false;
+        io_uring_cqe_seen(&ring, cqe);
+        --inflight;
+    }
+
+    io_uring_queue_exit(&ring);
+    close(fd);
+    return ok;
+}
+#else
+bool BatchReader::readRangesUring(const std::string&,
+    const std::vector<Range>&, char*) {
+    return false;
+}
+#endif
+
+void BatchReader::readRangesThreaded(const std::string& dataPath,
+    const std::vector<Range>& ranges, char* staging) {
+    // each worker owns a stream and pulls the next range off a shared counter
+    std::atomic<size_t> next{ 0 };
+    std::function<void()> work = [&]() {
+        std::ifstream in(dataPath, std::ios::binary);
+        for (size_t i = next++; i < ranges.size(); i = next++) {
+            const Range& r = ranges[i];
+            in.clear();
+            in.seekg(r.fileOffset);
+            in.read(staging + r.bufferPos, r.length);
+        }
+        };
+
+    if (ranges.size() < 2) {
+        work();
+        return;
+    }
+    ReadPool::instance().run(ranges.size() - 1, work);
+}
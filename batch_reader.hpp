@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/// Fetches many fixed-size rows from a data file in one batch.
+/// Offsets are sorted, adjacent rows are coalesced into larger reads, and
+/// the reads are submitted asynchronously: through io_uring when built with
+/// DBMS_USE_IO_URING (link with -luring), otherwise on a pool of reader
+/// threads that is started once and reused by every batch. Neither the
+/// project file nor a plain build defines DBMS_USE_IO_URING, so io_uring is
+/// opt-in: pass -DDBMS_USE_IO_URING and -luring on a Linux with liburing.
+class BatchReader {
+public:
+    /// Rows closer than this many bytes are fetched with a single read
+    static constexpr long GAP_LIMIT = 4096;
+    /// Upper bound on a single coalesced read, so work spreads across workers
+    static constexpr long MAX_READ = 1 << 20;
+
+    /// Read the row at each offset into `rows`, laid out in input order
+    /// (row i starts at rows[i * rowSize]). Offsets < 0 leave a zeroed row.
+    static void readRows(const std::string& dataPath,
+        const std::vector<long>& offsets,
+        int rowSize,
+        std::vector<char>& rows);
+
+private:
+    struct Range {
+        long   fileOffset;  // where the read starts in the data file
+        long   length;      // bytes to read
+        size_t bufferPos;   // where the bytes land in the staging buffer
+    };
+
+    static bool readRangesUring(const std::string& dataPath,
+        const std::vector<Range>& ranges, char* staging);
+    static void readRangesThreaded(const std::string& dataPath,
+        const std::vector<Range>& ranges, char* staging);
+};
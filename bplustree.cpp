@@ -101,7 +101,22 @@ void BPlusTree::insert(const std::string& key, long recordOffset) {
         allocateNode();  // create root
     }
     Node root = readNode(0);
-    splitAndInsert(root, key, recordOffset);
+    std::string separator;
+    long rightPage = -1;
+    if (!splitAndInsert(root, key, recordOffset, separator, rightPage)) {
+        return;
+    }
+
+    // the root split: move its left half off page 0 so the root stays there
+    root.selfPage = allocateNode();
+    writeNode(root);
+    Node newRoot(false);
+    newRoot.selfPage = 0;
+    newRoot.keyCount = 1;
+    copyKey(newRoot.keys[0], separator);
+    newRoot.children[0] = root.selfPage;
+    newRoot.children[1] = rightPage;
+    writeNode(newRoot);
 }
 
 bool BPlusTree::search(const std::string& key, long& recordOffset) {
@@ -125,36 +140,196 @@ bool BPlusTree::search(const std::string& key, long& recordOffset) {
     return false;
 }
 
-void BPlusTree::splitAndInsert(Node& node, const std::string& key, long recordOffset) {
-    if (node.isLeaf) {
-        // find insert position
-        int i = 0;
-        while (i < node.keyCount && key > node.keys[i]) ++i;
+void BPlusTree::searchBatch(const std::vector<std::string>& keys, std::vector<long>& offsets) {
+    offsets.assign(keys.size(), -1);
+    if (pageCount == 0) {
+        return;
+    }
+    size_t k = 0;
+    while (k < keys.size()) {
+        // descend once for the first unresolved key, remembering the
+        // tightest separator above the leaf we land in
+        Node node = readNode(0);
+        std::string upper;
+        bool bounded = false;
+        while (!node.isLeaf) {
+            int i = 0;
+            while (i < node.keyCount && keys[k] > node.keys[i]) ++i;
+            if (i < node.keyCount) {
+                upper = node.keys[i];
+                bounded = true;
+            }
+            node = readNode(node.children[i]);
+        }
+        // resolve every key that belongs to this leaf with one merge pass
+        int j = 0;
+        do {
+            while (j < node.keyCount && keys[k] > node.keys[j]) ++j;
+            if (j < node.keyCount && keys[k] == node.keys[j]) {
+                offsets[k] = node.children[j];
+            }
+            ++k;
+        } while (k < keys.size() && (!bounded || keys[k] <= upper));
+    }
+}
 
-        // shift keys and pointers to make room
-        for (int j = node.keyCount; j > i; --j) {
-            std::memcpy(node.keys[j], node.keys[j - 1], KEY_SIZE);
-            node.children[j] = node.children[j - 1];
+void BPlusTree::bulkLoad(const std::function<bool(std::string&, long&)>& next) {
+    if (pageCount != 0) {
+        std::cerr << "Bulk load error: " << filePath << " is not empty\n";
+        return;
+    }
+    // (max key, page) of every node on the level being built
+    std::vector<std::pair<std::string, long>> level;
+    Node leaf(true);
+    bool multiLevel = false;
+    std::string key;
+    long offset;
+    while (next(key, offset)) {
+        if (leaf.keyCount == LEAF_FILL) {
+            // a full leaf followed by more keys: page 0 is kept for the root
+            if (!multiLevel) {
+                Node root(false);
+                root.selfPage = 0;
+                writeNode(root);
+                pageCount = 1;
+                multiLevel = true;
+            }
+            leaf.selfPage = pageCount++;
+            leaf.nextLeafPage = pageCount;  // leaves are written on consecutive pages
+            writeNode(leaf);
+            level.push_back({ leaf.keys[leaf.keyCount - 1], leaf.selfPage });
+            leaf = Node(true);
         }
+        copyKey(leaf.keys[leaf.keyCount], key);
+        leaf.children[leaf.keyCount] = offset;
+        leaf.keyCount++;
+    }
 
-        // copy new key safely
-        std::size_t copyLen = std::min<std::size_t>(key.size(), KEY_SIZE - 1);
-        std::memcpy(node.keys[i], key.data(), copyLen);
-        node.keys[i][copyLen] = '\0';
+    if (!multiLevel) {
+        if (leaf.keyCount > 0) {
+            leaf.selfPage = 0;
+            writeNode(leaf);
+            pageCount = 1;
+        }
+        return;
+    }
+    leaf.selfPage = pageCount++;
+    writeNode(leaf);
+    level.push_back({ leaf.keys[leaf.keyCount - 1], leaf.selfPage });
 
-        // insert pointer
-        node.children[i] = recordOffset;
-        node.keyCount++;
+    // build internal levels until one node remains; it goes to page 0.
+    // keys[i] is the largest key under children[i], matching search().
+    const size_t fanout = ORDER + 1;
+    while (true) {
+        bool isRoot = level.size() <= fanout;
+        std::vector<std::pair<std::string, long>> parents;
+        for (size_t i = 0; i < level.size(); i += fanout) {
+            size_t end = std::min(level.size(), i + fanout);
+            Node node(false);
+            node.keyCount = static_cast<int>(end - i - 1);
+            for (size_t j = i; j < end; ++j) {
+                node.children[j - i] = level[j].second;
+                if (j + 1 < end) copyKey(node.keys[j - i], level[j].first);
+            }
+            node.selfPage = isRoot ? 0 : pageCount++;
+            writeNode(node);
+            parents.push_back({ level[end - 1].first, node.selfPage });
+        }
+        if (isRoot) break;
+        level.swap(parents);
+    }
+}
+
+void BPlusTree::copyKey(char* dst, const std::string& key) {
+    std::size_t copyLen = std::min<std::size_t>(key.size(), KEY_SIZE - 1);
+    std::memset(dst, 0, KEY_SIZE);
+    std::memcpy(dst, key.data(), copyLen);
+}
 
+bool BPlusTree::splitAndInsert(Node& node, const std::string& key, long recordOffset,
+    std::string& separator, long& rightPage) {
+    // find the slot for key; in an internal node, the child that covers it
+    int i = 0;
+    while (i < node.keyCount && key > node.keys[i]) ++i;
+
+    // entry to add at position i: the key itself in a leaf, or the
+    // separator pushed up by a child split in an internal node
+    std::string newKey = key;
+    long newChild = recordOffset;
+    if (!node.isLeaf) {
+        Node child = readNode(node.children[i]);
+        if (!splitAndInsert(child, key, recordOffset, newKey, newChild)) {
+            return false;
+        }
+    }
+
+    // gather the keys and pointers with the new entry in place. A leaf
+    // pairs keys[j] with children[j]; an internal node has one more child,
+    // and the new right half of children[i] goes in after it.
+    const int keyCount = node.keyCount + 1;
+    const int childCount = node.isLeaf ? keyCount : keyCount + 1;
+    const int childAt = node.isLeaf ? i : i + 1;
+    std::vector<char> keys((size_t)keyCount * KEY_SIZE);
+    std::vector<long> children(childCount);
+    for (int j = 0, src = 0; j < keyCount; ++j) {
+        if (j == i) copyKey(&keys[(size_t)j * KEY_SIZE], newKey);
+        else std::memcpy(&keys[(size_t)j * KEY_SIZE], node.keys[src++], KEY_SIZE);
+    }
+    for (int j = 0, src = 0; j < childCount; ++j) {
+        children[j] = j == childAt ? newChild : node.children[src++];
+    }
+
+    auto fill = [&](Node& n, int firstKey, int keysIn, int firstChild, int childrenIn) {
+        std::memset(n.keys, 0, sizeof(n.keys));
+        for (int j = 0; j < ORDER + 1; ++j) n.children[j] = -1;
+        std::memcpy(n.keys, &keys[(size_t)firstKey * KEY_SIZE], (size_t)keysIn * KEY_SIZE);
+        for (int j = 0; j < childrenIn; ++j) n.children[j] = children[firstChild + j];
+        n.keyCount = keysIn;
+        };
+
+    if (keyCount <= ORDER) {
+        fill(node, 0, keyCount, 0, childCount);
         writeNode(node);
-        // TODO: handle split when node.keyCount > ORDER
+        return false;
+    }
+
+    // overflow: keep the lower half here and move the upper half to a new
+    // page. The separator is the largest key left behind, as in bulkLoad.
+    Node right(node.isLeaf);
+    right.selfPage = allocateNode();
+    const int half = keyCount / 2;
+    if (node.isLeaf) {
+        fill(right, half, keyCount - half, half, keyCount - half);
+        fill(node, 0, half, 0, half);
+        right.nextLeafPage = node.nextLeafPage;
+        node.nextLeafPage = right.selfPage;
+        separator.assign(node.keys[half - 1]);
     }
     else {
-        // descend to correct child
-        int i = 0;
-        while (i < node.keyCount && key > node.keys[i]) ++i;
-        Node child = readNode(node.children[i]);
-        splitAndInsert(child, key, recordOffset);
+        // keys[half] bounds children[half], the last child kept on the left
+        separator.assign(&keys[(size_t)half * KEY_SIZE]);
+        fill(right, half + 1, keyCount - half - 1, half + 1, childCount - half - 1);
+        fill(node, 0, half, 0, half + 1);
+    }
+    writeNode(right);
+    writeNode(node);
+    rightPage = right.selfPage;
+    return true;
+}
+
+void BPlusTree::scanInOrder(const std::function<bool(const char*, long)>& visit) {
+    if (pageCount == 0) return;
+
+    Node node = readNode(0);
+    while (!node.isLeaf) {
+        node = readNode(node.children[0]);
+    }
+    while (true) {
+        for (int i = 0; i < node.keyCount; ++i) {
+            if (!visit(node.keys[i], node.children[i])) return;
+        }
+        if (node.nextLeafPage == -1) break;
+        node = readNode(node.nextLeafPage);
     }
 }
 
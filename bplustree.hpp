@@ -4,6 +4,8 @@
 #include <cstring>
 #include <fstream>
 #include<iostream>
+#include <vector>
+#include <functional>
 
 /// A disk‐based B+-tree with fixed 4KB pages.
 /// Keys are fixed‐length strings (max 40 bytes), values are 8‐byte offsets.
@@ -39,12 +41,29 @@ public:
     explicit BPlusTree(const std::string& filename);
     ~BPlusTree();
 
-    /// Insert key→recordOffset mapping
+    /// Insert key→recordOffset mapping, splitting full nodes on the way back
+    /// up; the root always stays on page 0
     void insert(const std::string& key, long recordOffset);
 
     /// Search for key; if found, set recordOffset and return true
     bool search(const std::string& key, long& recordOffset);
 
+    /// Search for many keys at once. `keys` must be sorted ascending;
+    /// offsets[i] is set to the match for keys[i], or -1 if absent.
+    /// Keys that fall in the same leaf share a single root-to-leaf descent.
+    void searchBatch(const std::vector<std::string>& keys, std::vector<long>& offsets);
+
+    /// Build the tree bottom-up from an empty file. `next` yields keys in
+    /// strictly ascending order and returns false when done. Leaves are
+    /// filled to LEAF_FILL, so scattered inserts do not split every leaf.
+    void bulkLoad(const std::function<bool(std::string& key, long& recordOffset)>& next);
+
+    static constexpr int LEAF_FILL = ORDER - ORDER / 8;
+
+    /// Visit every key in ascending order by walking the leaf chain.
+    /// Stops early when `visit` returns false.
+    void scanInOrder(const std::function<bool(const char* key, long recordOffset)>& visit);
+
 private:
     std::string filePath;
     long        pageCount;
@@ -52,6 +71,10 @@ private:
     long  allocateNode();
     void  writeNode(const Node& node);
     Node  readNode(long page);
-    void  splitAndInsert(Node& node, const std::string& key, long recordOffset);
+    /// Insert below node; returns true if node split, with the separator
+    /// (largest key left in node) and the page of its new right sibling
+    bool  splitAndInsert(Node& node, const std::string& key, long recordOffset,
+        std::string& separator, long& rightPage);
+    static void copyKey(char* dst, const std::string& key);
     bool findRecordAtIndex(int index, long& recordOffset);
 };
@@ -0,0 +1,384 @@
+#include "cluster_manager.hpp"
+#include "schema.hpp"
+#include "bplustree.hpp"
+#include "external_sort.hpp"
+#include "index_builder.hpp"
+#include "index_manager.hpp"
+#include "table_scan.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int KEY_SIZE = RowView::SORT_KEY_SIZE;
+
+    struct Layout {
+        std::string tablePath;
+        std::string dataPath;
+        std::vector<Schema::Field> fields;
+        std::vector<std::string> uniqueKeys;
+        std::string clusterKey;
+        int  col = -1;
+        bool isInt = false;
+        int  rowSize = 0;
+        long totalRows = 0;
+        long sortedRows = 0;          // rows [0, sortedRows) are in key order
+        int  rowsPerBlock = 1;
+        std::vector<char> fences;     // first sort key of every block
+
+        long blockCount() const { return (long)(fences.size() / KEY_SIZE); }
+        const char* fence(long b) const { return fences.data() + b * KEY_SIZE; }
+    };
+
+    // rows per page-sized block of the sorted region
+    int blockRowsFor(int rowSize) {
+        return std::max(1, BPlusTree::PAGE_SIZE / rowSize);
+    }
+
+    // Read the schema and cluster.fence; false if the table is not clustered
+    bool loadLayout(const std::string& tableName, Layout& l, bool withFences) {
+        l.tablePath = "Tables/" + tableName;
+        l.dataPath = l.tablePath + "/data.tbl";
+        Schema schema = Schema::loadFromFile(l.tablePath + "/meta.txt");
+        l.clusterKey = schema.getClusterKey();
+        if (l.clusterKey.empty()) return false;
+
+        l.fields = schema.getFields();
+        l.uniqueKeys = schema.getUniqueKeys();
+        l.col = schema.fieldIndex(l.clusterKey);
+        if (l.col < 0) return false;
+        l.isInt = l.fields[l.col].type == "int";
+        l.rowSize = schema.rowSize();
+        l.totalRows = TableScan::rowCount(l.dataPath, l.rowSize);
+
+        std::ifstream in(l.tablePath + "/cluster.fence", std::ios::binary);
+        if (!in) return true;  // clustered, but nothing sorted yet
+        int64_t sorted = 0;
+        int32_t blockRows = 1;
+        in.read(reinterpret_cast<char*>(&sorted), sizeof(sorted));
+        in.read(reinterpret_cast<char*>(&blockRows), sizeof(blockRows));
+        l.sortedRows = (long)sorted;
+        l.rowsPerBlock = std::max<int32_t>(1, blockRows);
+        if (withFences) {
+            long blocks = (l.sortedRows + l.rowsPerBlock - 1) / l.rowsPerBlock;
+            l.fences.resize((size_t)blocks * KEY_SIZE);
+            in.read(l.fences.data(), l.fences.size());
+        }
+        return true;
+    }
+
+    void encodeRowKey(const Layout& l, const char* row, char* out) {
+        RowView::encodeSortKey(RowView(row).field(l.col), l.isInt, out);
+    }
+
+    // Last block whose first key is <= key, or -1 if key sorts before them all
+    long findBlock(const Layout& l, const char* key) {
+        long lo = 0, hi = l.blockCount();
+        while (lo < hi) {
+            long mid = (lo + hi) / 2;
+            if (std::memcmp(l.fence(mid), key, KEY_SIZE) <= 0) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo - 1;
+    }
+}
+
+bool ClusterManager::rebuild(const std::string& tableName, const std::string& clusterKey) {
+    const std::string tablePath = "Tables/" + tableName;
+    const std::string dataPath = tablePath + "/data.tbl";
+    const std::string buildPath = tablePath + "/data.tbl.build";
+    const std::string tmpDir = tablePath + "/.cluster_tmp";
+    Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+    const auto fields = schema.getFields();
+    const auto uniqueKeys = schema.getUniqueKeys();
+
+    const int col = schema.fieldIndex(clusterKey);
+    if (col < 0) {
+        std::cout << "Field not in schema\n";
+        return false;
+    }
+    const bool isInt = fields[col].type == "int";
+    const int rowSize = schema.rowSize();
+    const size_t recordSize = KEY_SIZE + rowSize;
+    const int blockRows = blockRowsFor(rowSize);
+
+    // 1) sort every row (sorted region and overflow alike) by cluster key
+    std::vector<char> fences;
+    long rowsRead = 0;
+    long sortedRows = 0;
+    bool duplicate = false;
+    bool written = true;
+    std::string badKey;
+    {
+        auto less = [](const char* a, const char* b) { return std::memcmp(a, b, KEY_SIZE) < 0; };
+        ExternalSorter sorter(recordSize, REORG_MEMORY, tmpDir, less);
+        std::ifstream data(dataPath, std::ios::binary);
+        std::vector<char> buf((size_t)SCAN_BLOCKS * blockRows * rowSize);
+        std::vector<char> record(recordSize);
+        while (data) {
+            data.read(buf.data(), buf.size());
+            size_t n = (size_t)data.gcount() / rowSize;
+            for (size_t i = 0; i < n; ++i) {
+                const char* row = buf.data() + i * rowSize;
+                std::string_view value = RowView(row).field(col);
+                if (isInt && !RowView::isCanonicalInt(value)) {
+                    badKey.assign(value);
+                    break;
+                }
+                RowView::encodeSortKey(value, isInt, record.data());
+                std::memcpy(record.data() + KEY_SIZE, row, rowSize);
+                sorter.add(record.data());
+            }
+            if (!badKey.empty()) break;
+            rowsRead += (long)n;
+        }
+        if (data.bad() || !badKey.empty()) written = false;
+
+        // 2) write the sorted rows, noting the first key of every block
+        std::ofstream out(buildPath, std::ios::binary | std::ios::trunc);
+        std::vector<char> previous(KEY_SIZE);
+        if (written && sorter.finish()) {
+            while (out && sorter.next(record.data())) {
+                if (sortedRows > 0 && std::memcmp(record.data(), previous.data(), KEY_SIZE) == 0) {
+                    duplicate = true;
+                    break;
+                }
+                std::memcpy(previous.data(), record.data(), KEY_SIZE);
+                if (sortedRows % blockRows == 0)
+                    fences.insert(fences.end(), record.data(), record.data() + KEY_SIZE);
+                out.write(record.data() + KEY_SIZE, rowSize);
+                ++sortedRows;
+            }
+        }
+        out.close();
+        if (!out || sorter.failed()) written = false;
+    }
+    std::error_code ec;
+    fs::remove_all(tmpDir, ec);
+    if (duplicate) {
+        fs::remove(buildPath, ec);
+        std::cout << "Duplicate values in '" << clusterKey << "'.\n";
+        return false;
+    }
+    if (!badKey.empty()) {
+        fs::remove(buildPath, ec);
+        std::cout << "Value '" << badKey << "' of int field '" << clusterKey
+            << "' is not a plain integer.\n";
+        return false;
+    }
+    // data.tbl is replaced below, so every row read must have been written
+    if (!written || sortedRows != rowsRead) {
+        fs::remove(buildPath, ec);
+        std::cout << "Reorganization aborted: wrote " << sortedRows << " of "
+            << rowsRead << " rows.\n";
+        return false;
+    }
+
+    // 3) every row moved, so every index is rebuilt against the new file
+    auto discardBuild = [&]() {
+        for (const auto& k : uniqueKeys) fs::remove(tablePath + "/" + k + ".idx.build", ec);
+        fs::remove(tablePath + "/cluster.fence.build", ec);
+        fs::remove(buildPath, ec);
+        };
+    for (const auto& key : uniqueKeys) {
+        long indexedRows = 0;
+        if (!IndexBuilder::buildIndex(tableName, key, buildPath,
+            tablePath + "/" + key + ".idx.build", indexedRows)) {
+            discardBuild();
+            return false;
+        }
+    }
+    {
+        std::ofstream fence(tablePath + "/cluster.fence.build", std::ios::binary | std::ios::trunc);
+        int64_t sorted = sortedRows;
+        int32_t rows = blockRows;
+        fence.write(reinterpret_cast<const char*>(&sorted), sizeof(sorted));
+        fence.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        fence.write(fences.data(), fences.size());
+        fence.close();
+        if (!fence) {
+            discardBuild();
+            std::cout << "Reorganization aborted: cannot write cluster.fence.\n";
+            return false;
+        }
+    }
+
+    // rows appended since the scan are not in the new file; renaming now would drop them
+    if (TableScan::rowCount(dataPath, rowSize) != rowsRead) {
+        discardBuild();
+        std::cout << "Reorganization aborted: table changed while it was being sorted.\n";
+        return false;
+    }
+
+    // 4) swap the new files in
+    fs::rename(buildPath, dataPath);
+    for (const auto& key : uniqueKeys) {
+        fs::rename(tablePath + "/" + key + ".idx.build", tablePath + "/" + key + ".idx");
+    }
+    fs::rename(tablePath + "/cluster.fence.build", tablePath + "/cluster.fence");
+    return true;
+}
+
+void ClusterManager::clusterTable(const std::string& tableName) {
+    const std::string tablePath = "Tables/" + tableName;
+    Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+
+    std::cout << "Enter primary key to cluster by: ";
+    std::string field;
+    std::getline(std::cin, field);
+    field = Utils::trim(field);
+
+    const auto uniqueKeys = schema.getUniqueKeys();
+    if (std::find(uniqueKeys.begin(), uniqueKeys.end(), field) == uniqueKeys.end()) {
+        std::cout << "Cluster key must be a unique field.\n"; return;
+    }
+    if (!rebuild(tableName, field)) {
+        std::cout << "Table not clustered.\n"; return;
+    }
+
+    schema.setClusterKey(field);
+    schema.saveToFile(tablePath + "/meta.txt.tmp");
+    fs::rename(tablePath + "/meta.txt.tmp", tablePath + "/meta.txt");
+    std::cout << "Table '" << tableName << "' clustered by '" << field << "'.\n";
+}
+
+bool ClusterManager::reorganize(const std::string& tableName) {
+    Schema schema = Schema::loadFromFile("Tables/" + tableName + "/meta.txt");
+    if (schema.getClusterKey().empty()) {
+        std::cout << "Table is not clustered.\n";
+        return false;
+    }
+    return rebuild(tableName, schema.getClusterKey());
+}
+
+void ClusterManager::maybeReorganize(const std::string& tableName) {
+    Layout l;
+    if (!loadLayout(tableName, l, false)) return;
+    long overflow = l.totalRows - l.sortedRows;
+    if (overflow > std::max(REORG_MIN_ROWS, l.sortedRows / REORG_RATIO)) {
+        std::cout << "Reorganizing clustered table...\n";
+        rebuild(tableName, l.clusterKey);
+    }
+}
+
+bool ClusterManager::lookup(const std::string& tableName, const std::string& key,
+    std::vector<char>& row) {
+    Layout l;
+    if (!loadLayout(tableName, l, true)) return false;
+    // stored ints are canonical, so "07" or "abc" cannot match any row
+    if (l.isInt && !RowView::isCanonicalInt(key)) return false;
+    char target[KEY_SIZE];
+    char current[KEY_SIZE];
+    RowView::encodeSortKey(key, l.isInt, target);
+    row.resize(l.rowSize);
+
+    // 1) the fence names the only block that can hold key: one read
+    long b = findBlock(l, target);
+    if (b >= 0) {
+        long first = b * l.rowsPerBlock;
+        long n = std::min<long>(l.rowsPerBlock, l.sortedRows - first);
+        std::vector<char> block((size_t)n * l.rowSize);
+        std::ifstream data(l.dataPath, std::ios::binary);
+        data.seekg((std::streamoff)first * l.rowSize);
+        data.read(block.data(), block.size());
+
+        long lo = 0, hi = n;
+        while (lo < hi) {
+            long mid = (lo + hi) / 2;
+            encodeRowKey(l, block.data() + mid * l.rowSize, current);
+            int cmp = std::memcmp(current, target, KEY_SIZE);
+            if (cmp == 0) {
+                std::memcpy(row.data(), block.data() + mid * l.rowSize, l.rowSize);
+                return true;
+            }
+            if (cmp < 0) lo = mid + 1;
+            else hi = mid;
+        }
+    }
+
+    // 2) not among the sorted rows: only the overflow tail is left
+    if (l.totalRows == l.sortedRows) return false;
+    IndexManager im(tableName, l.tablePath);
+    im.loadIndexes(l.uniqueKeys);
+    long off = im.searchIndex(l.clusterKey, key);
+    if (off < 0) return false;
+    std::ifstream data(l.dataPath, std::ios::binary);
+    data.seekg(off);
+    data.read(row.data(), l.rowSize);
+    return true;
+}
+
+void ClusterManager::rangeScan(const std::string& tableName, const std::string& lo,
+    const std::string& hi, const std::function<void(const RowView&)>& visit) {
+    Layout l;
+    if (!loadLayout(tableName, l, true)) return;
+    if (l.isInt && (!RowView::isCanonicalInt(lo) || !RowView::isCanonicalInt(hi))) {
+        std::cout << "Range bounds on '" << l.clusterKey << "' must be integers.\n";
+        return;
+    }
+    char loKey[KEY_SIZE], hiKey[KEY_SIZE], key[KEY_SIZE];
+    RowView::encodeSortKey(lo, l.isInt, loKey);
+    RowView::encodeSortKey(hi, l.isInt, hiKey);
+    const size_t recordSize = KEY_SIZE + l.rowSize;
+    const long chunkRows = SCAN_BLOCKS * l.rowsPerBlock;
+    std::vector<char> buf((size_t)chunkRows * l.rowSize);
+    std::ifstream data(l.dataPath, std::ios::binary);
+
+    // 1) overflow rows in range, sorted so they can be merged in
+    std::vector<char> extra;
+    data.seekg((std::streamoff)l.sortedRows * l.rowSize);
+    while (data) {
+        data.read(buf.data(), buf.size());
+        size_t n = (size_t)data.gcount() / l.rowSize;
+        for (size_t i = 0; i < n; ++i) {
+            const char* row = buf.data() + i * l.rowSize;
+            encodeRowKey(l, row, key);
+            if (std::memcmp(key, loKey, KEY_SIZE) < 0 || std::memcmp(key, hiKey, KEY_SIZE) > 0) continue;
+            extra.insert(extra.end(), key, key + KEY_SIZE);
+            extra.insert(extra.end(), row, row + l.rowSize);
+        }
+    }
+    std::vector<size_t> order(extra.size() / recordSize);
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::memcmp(extra.data() + a * recordSize, extra.data() + b * recordSize, KEY_SIZE) < 0;
+        });
+    size_t nextExtra = 0;
+    auto emitExtraBelow = [&](const char* bound) {
+        while (nextExtra < order.size()) {
+            const char* rec = extra.data() + order[nextExtra] * recordSize;
+            if (bound && std::memcmp(rec, bound, KEY_SIZE) >= 0) break;
+            visit(RowView(rec + KEY_SIZE));
+            ++nextExtra;
+        }
+        };
+
+    // 2) sorted rows: one sequential pass starting at the block holding lo
+    long row = std::max(0L, findBlock(l, loKey)) * l.rowsPerBlock;
+    data.clear();
+    data.seekg((std::streamoff)row * l.rowSize);
+    bool done = false;
+    while (!done && row < l.sortedRows) {
+        long n = std::min(chunkRows, l.sortedRows - row);
+        data.read(buf.data(), (std::streamsize)n * l.rowSize);
+        n = (long)(data.gcount() / l.rowSize);
+        if (n == 0) break;
+        for (long i = 0; i < n; ++i) {
+            const char* r = buf.data() + i * l.rowSize;
+            encodeRowKey(l, r, key);
+            if (std::memcmp(key, loKey, KEY_SIZE) < 0) continue;
+            if (std::memcmp(key, hiKey, KEY_SIZE) > 0) { done = true; break; }
+            emitExtraBelow(key);
+            visit(RowView(r));
+        }
+        row += n;
+    }
+    emitExtraBelow(nullptr);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "row_view.hpp"
+
+/// Optional clustered layout: data.tbl keeps its rows sorted by the table's
+/// cluster key (a unique field), followed by an unsorted overflow tail of
+/// rows added since the last reorganization. cluster.fence records how many
+/// rows are sorted and the first key of every page-sized block, so a point
+/// lookup reads one block and a key range is one sequential read. Once the
+/// overflow outgrows 1/REORG_RATIO of the sorted rows, the table is
+/// re-sorted and its indexes are rebuilt.
+class ClusterManager {
+public:
+    /// Memory budget for the sort run during reorganization
+    static constexpr size_t REORG_MEMORY = 64 * 1024 * 1024;
+    /// Overflow rows always tolerated before reorganizing
+    static constexpr long REORG_MIN_ROWS = 1024;
+    /// Reorganize once overflow exceeds sortedRows / REORG_RATIO
+    static constexpr long REORG_RATIO = 8;
+    /// Blocks fetched per sequential read during a range scan
+    static constexpr long SCAN_BLOCKS = 64;
+
+    /// Prompt for a unique field and cluster the table by it
+    static void clusterTable(const std::string& tableName);
+
+    /// Re-sort a clustered table, folding the overflow into the sorted rows
+    static bool reorganize(const std::string& tableName);
+
+    /// Reorganize if the overflow has grown past the threshold
+    static void maybeReorganize(const std::string& tableName);
+
+    /// Fetch the row whose cluster key equals key; false if absent
+    static bool lookup(const std::string& tableName, const std::string& key,
+        std::vector<char>& row);
+
+    /// Visit rows with lo <= cluster key <= hi in key order
+    static void rangeScan(const std::string& tableName, const std::string& lo,
+        const std::string& hi, const std::function<void(const RowView&)>& visit);
+
+private:
+    static bool rebuild(const std::string& tableName, const std::string& clusterKey);
+};
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include "table_manager.hpp"
+#include "join_manager.hpp"
 
 int main() {
     while (true) {
@@ -9,7 +10,8 @@ int main() {
         std::cout << "1. Create Table\n";
         std::cout << "2. Use Table\n";
         std::cout << "3. Delete Table\n";
-        std::cout << "4. Exit\n";
+        std::cout << "4. Join Tables\n";
+        std::cout << "5. Exit\n";
         std::cout << "Enter choice: ";
 
         int choice;
@@ -26,6 +28,9 @@ int main() {
             TableManager::deleteTable();
             break;
         case 4:
+            JoinManager::joinTables();
+            break;
+        case 5:
             return 0;
         default:
             std::cout << "Invalid choice!\n";
@@ -0,0 +1,216 @@
+#include "external_sort.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // run files from every sorter share a directory, so names must be unique
+    std::atomic<unsigned long> runSequence{ 0 };
+}
+
+ExternalSorter::ExternalSorter(size_t recordSize_, size_t memoryBudget,
+    const std::string& tempDir_, Less less_)
+    : recordSize(recordSize_), tempDir(tempDir_), less(std::move(less_)) {
+    // every buffered record also costs one slot of the sort permutation
+    capacity = std::max<size_t>(1, memoryBudget / (recordSize + sizeof(size_t)));
+}
+
+ExternalSorter::~ExternalSorter() {
+    runs.clear();
+    for (const auto& f : runFiles) {
+        std::error_code ec;
+        fs::remove(f, ec);
+    }
+}
+
+void ExternalSorter::fail(const std::string& what) {
+    if (!error) {
+        std::cerr << "External sort error: " << what << "\n";
+    }
+    error = true;
+}
+
+void ExternalSorter::add(const char* record) {
+    if (buffered == capacity) {
+        spillRun();
+    }
+    if (buffer.size() < (buffered + 1) * recordSize) {
+        buffer.resize(std::min(capacity, std::max<size_t>(64, buffered * 2)) * recordSize);
+    }
+    std::memcpy(buffer.data() + buffered * recordSize, record, recordSize);
+    ++buffered;
+    ++added;
+}
+
+void ExternalSorter::mergeFrom(ExternalSorter& other) {
+    if (other.buffered > 0) {
+        other.spillRun();
+    }
+    runFiles.insert(runFiles.end(), other.runFiles.begin(), other.runFiles.end());
+    other.runFiles.clear();
+    added += other.added;
+    other.added = 0;
+    if (other.error) error = true;
+}
+
+void ExternalSorter::sortBuffer() {
+    order.resize(buffered);
+    for (size_t i = 0; i < buffered; ++i) order[i] = i;
+    const char* base = buffer.data();
+    size_t size = recordSize;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return less(base + a * size, base + b * size);
+        });
+}
+
+std::string ExternalSorter::newRunPath() {
+    return tempDir + "/run_" + std::to_string(runSequence++) + ".tmp";
+}
+
+void ExternalSorter::spillRun() {
+    sortBuffer();
+    std::error_code ec;
+    fs::create_directories(tempDir, ec);
+    std::string path = newRunPath();
+    std::ofstream out(path, std::ios::binary);
+    for (size_t i : order) {
+        if (!out) break;
+        out.write(buffer.data() + i * recordSize, recordSize);
+    }
+    out.close();
+    if (!out) {
+        fail("cannot write run file " + path);
+    }
+    runFiles.push_back(path);
+    buffered = 0;
+    order.clear();
+}
+
+bool ExternalSorter::openRuns(const std::vector<std::string>& files) {
+    runs.clear();
+    heap.clear();
+    heads.assign(files.size() * recordSize, 0);
+    for (const auto& f : files) {
+        runs.emplace_back(f, std::ios::binary);
+        if (!runs.back().is_open()) {
+            fail("cannot open run file " + f);
+            runs.clear();
+            return false;
+        }
+    }
+    auto greater = [&](size_t a, size_t b) {
+        return less(heads.data() + b * recordSize, heads.data() + a * recordSize);
+        };
+    for (size_t r = 0; r < runs.size(); ++r) {
+        if (advanceRun(r)) heap.push_back(r);
+    }
+    std::make_heap(heap.begin(), heap.end(), greater);
+    return !error;
+}
+
+bool ExternalSorter::popMerged(char* out) {
+    if (error || heap.empty()) return false;
+    auto greater = [&](size_t a, size_t b) {
+        return less(heads.data() + b * recordSize, heads.data() + a * recordSize);
+        };
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    size_t run = heap.back();
+    std::memcpy(out, heads.data() + run * recordSize, recordSize);
+    if (advanceRun(run)) {
+        std::push_heap(heap.begin(), heap.end(), greater);
+    }
+    else {
+        heap.pop_back();
+    }
+    return true;
+}
+
+bool ExternalSorter::mergePass() {
+    // merge groups of MAX_FAN_IN runs into one run each
+    std::vector<std::string> merged;
+    std::vector<char> record(recordSize);
+    for (size_t first = 0; first < runFiles.size(); first += MAX_FAN_IN) {
+        size_t last = std::min(runFiles.size(), first + MAX_FAN_IN);
+        std::vector<std::string> group(runFiles.begin() + first, runFiles.begin() + last);
+        if (!openRuns(group)) break;
+
+        std::string path = newRunPath();
+        merged.push_back(path);
+        std::ofstream out(path, std::ios::binary);
+        while (out && popMerged(record.data())) {
+            out.write(record.data(), recordSize);
+        }
+        out.close();
+        runs.clear();
+        if (!out) {
+            fail("cannot write run file " + path);
+        }
+        if (error) break;
+        for (const auto& f : group) {
+            std::error_code ec;
+            fs::remove(f, ec);
+        }
+        std::fill(runFiles.begin() + first, runFiles.begin() + last, std::string());
+    }
+
+    // keep whatever was not consumed so the destructor can clean it up
+    for (auto& f : runFiles) {
+        if (!f.empty()) merged.push_back(std::move(f));
+    }
+    runFiles = std::move(merged);
+    return !error;
+}
+
+bool ExternalSorter::finish() {
+    if (error) return false;
+    // everything fit in memory: serve straight from the sorted buffer
+    if (runFiles.empty()) {
+        sortBuffer();
+        cursor = 0;
+        return true;
+    }
+    if (buffered > 0) {
+        spillRun();
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+
+    while (!error && runFiles.size() > MAX_FAN_IN) {
+        mergePass();
+    }
+    return !error && openRuns(runFiles);
+}
+
+bool ExternalSorter::advanceRun(size_t run) {
+    std::ifstream& in = runs[run];
+    if (in.read(heads.data() + run * recordSize, recordSize)) return true;
+    // a clean end of run reads nothing; anything else lost records
+    if (in.bad() || in.gcount() != 0 || !in.eof()) {
+        fail("short read from a run file in " + tempDir);
+    }
+    return false;
+}
+
+bool ExternalSorter::next(char* out) {
+    if (runFiles.empty()) {
+        if (cursor >= order.size()) return false;
+        std::memcpy(out, buffer.data() + order[cursor++] * recordSize, recordSize);
+        ++returned;
+        return true;
+    }
+
+    if (!popMerged(out)) {
+        if (!error && returned != added) {
+            fail("merge returned " + std::to_string(returned) + " of "
+                + std::to_string(added) + " records");
+        }
+        return false;
+    }
+    ++returned;
+    return true;
+}
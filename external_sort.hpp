@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Sorts fixed-size binary records under a memory budget.
+/// Records are buffered until the budget is reached, then the buffer is
+/// sorted and spilled to a run file in tempDir. finish() merges the runs
+/// with a k-way heap merge, at most MAX_FAN_IN at a time (intermediate
+/// passes write merged runs back to tempDir); if nothing spilled, the buffer
+/// is sorted in place. Any failed open, write or read marks the sorter
+/// failed() instead of silently dropping records.
+class ExternalSorter {
+public:
+    using Less = std::function<bool(const char*, const char*)>;
+
+    /// Run files open at once during a merge; stays well below the
+    /// per-process stdio stream limit (512 by default on Windows)
+    static constexpr size_t MAX_FAN_IN = 64;
+
+    ExternalSorter(size_t recordSize, size_t memoryBudget,
+        const std::string& tempDir, Less less);
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    /// Append one record of recordSize bytes
+    void add(const char* record);
+
+    /// Take over every record of `other` (spilling its buffer first), so
+    /// sorters filled by separate threads can be merged by one of them
+    void mergeFrom(ExternalSorter& other);
+
+    /// End of input; next() then returns records in ascending order.
+    /// Returns false if a run could not be written or reopened.
+    bool finish();
+
+    /// Copy the next record into out; false when the input is exhausted
+    /// or a run failed to read (check failed() to tell the two apart)
+    bool next(char* out);
+
+    /// True once any run I/O failed or the output came up short
+    bool failed() const { return error; }
+
+    /// Number of run files spilled so far
+    size_t runCount() const { return runFiles.size(); }
+
+private:
+    size_t      recordSize;
+    size_t      capacity;   // records held in memory before a spill
+    std::string tempDir;
+    Less        less;
+    bool        error = false;
+    size_t      added = 0;     // records taken in, including merged sorters
+    size_t      returned = 0;  // records handed out by next()
+
+    std::vector<char>   buffer;
+    size_t              buffered = 0;
+    std::vector<size_t> order;   // sorted permutation of the buffer
+    size_t              cursor = 0;
+
+    std::vector<std::string>   runFiles;
+    std::vector<std::ifstream> runs;
+    std::vector<char>          heads;  // current record of each run
+    std::vector<size_t>        heap;   // run indices, min-heap on heads
+
+    void sortBuffer();
+    void spillRun();
+    std::string newRunPath();
+    bool openRuns(const std::vector<std::string>& files);
+    bool popMerged(char* out);
+    bool mergePass();
+    bool advanceRun(size_t run);
+    void fail(const std::string& what);
+};
@@ -0,0 +1,195 @@
+#include "index_builder.hpp"
+#include "bplustree.hpp"
+#include "external_sort.hpp"
+#include "row_view.hpp"
+#include "schema.hpp"
+#include "table_scan.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int KEY_SIZE = RowView::SORT_KEY_SIZE;
+    constexpr int ENTRY_SIZE = KEY_SIZE + sizeof(int64_t);  // key, then row offset
+
+    // Index rows appended since indexedRows until none are left.
+    // Returns false at a duplicate key, which is left in duplicateKey.
+    bool catchUp(BPlusTree& tree, const std::string& dataPath, int rowSize, int col,
+        long& indexedRows, std::string& duplicateKey) {
+        std::ifstream data(dataPath, std::ios::binary);
+        std::vector<char> row(rowSize);
+        while (true) {
+            long currentRows = TableScan::rowCount(dataPath, rowSize);
+            if (currentRows <= indexedRows) return true;
+            data.clear();
+            data.seekg((std::streamoff)indexedRows * rowSize);
+            for (; indexedRows < currentRows && data.read(row.data(), rowSize); ++indexedRows) {
+                std::string key(RowView(row.data()).field(col));
+                long existing;
+                if (tree.search(key, existing)) {
+                    duplicateKey = key;
+                    return false;
+                }
+                tree.insert(key, indexedRows * rowSize);
+            }
+        }
+    }
+}
+
+bool IndexBuilder::buildIndex(const std::string& tableName, const std::string& field,
+    const std::string& dataPath, const std::string& idxPath, long& indexedRows,
+    size_t memoryBudget) {
+    const std::string tablePath = "Tables/" + tableName;
+    const std::string tmpDir = tablePath + "/.index_tmp";
+    Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+    const int col = schema.fieldIndex(field);
+    if (col < 0) {
+        std::cout << "Field not in schema\n";
+        return false;
+    }
+    const int rowSize = schema.rowSize();
+
+    // 1) parallel scan of the rows present right now, one sorter per thread.
+    //    Each row yields a (zero-padded key, offset) entry.
+    long snapshotRows = TableScan::rowCount(dataPath, rowSize);
+    unsigned threads = TableScan::threadsFor(snapshotRows);
+    auto less = [](const char* a, const char* b) { return std::memcmp(a, b, KEY_SIZE) < 0; };
+    std::vector<std::unique_ptr<ExternalSorter>> sorters;
+    for (unsigned t = 0; t < threads; ++t) {
+        sorters.push_back(std::make_unique<ExternalSorter>(
+            ENTRY_SIZE, memoryBudget / threads, tmpDir, less));
+    }
+    TableScan::parallelScan(dataPath, rowSize, snapshotRows, threads, SCAN_BATCH_ROWS,
+        [&](unsigned t, long firstRow, const char* rows, int n) {
+            char entry[ENTRY_SIZE];
+            for (int i = 0; i < n; ++i) {
+                std::string_view key = RowView(rows + (size_t)i * rowSize).field(col);
+                std::memset(entry, 0, KEY_SIZE);
+                std::memcpy(entry, key.data(), key.size());
+                int64_t offset = (int64_t)(firstRow + i) * rowSize;
+                std::memcpy(entry + KEY_SIZE, &offset, sizeof(offset));
+                sorters[t]->add(entry);
+            }
+        });
+
+    // 2) merge every thread's runs into one sorted stream
+    ExternalSorter& merged = *sorters[0];
+    for (unsigned t = 1; t < threads; ++t) {
+        merged.mergeFrom(*sorters[t]);
+    }
+    bool built = merged.finish();
+
+    indexedRows = snapshotRows;
+
+    // 3) bulk load bottom-up, stopping at the first duplicate key
+    fs::remove(idxPath);
+    bool duplicate = false;
+    std::string duplicateKey;
+    if (built) {
+        BPlusTree tree(idxPath);
+        char entry[ENTRY_SIZE];
+        char previous[ENTRY_SIZE];
+        bool first = true;
+        tree.bulkLoad([&](std::string& key, long& offset) {
+            if (!merged.next(entry)) return false;
+            if (!first && std::memcmp(entry, previous, KEY_SIZE) == 0) {
+                duplicate = true;
+                duplicateKey.assign(entry, strnlen(entry, KEY_SIZE));
+                return false;
+            }
+            first = false;
+            std::memcpy(previous, entry, ENTRY_SIZE);
+            int64_t off;
+            std::memcpy(&off, entry + KEY_SIZE, sizeof(off));
+            key.assign(entry, strnlen(entry, KEY_SIZE));
+            offset = (long)off;
+            return true;
+            });
+        built = !merged.failed();
+
+        // 4) catch up on rows appended while the index was being built
+        if (built && !duplicate) {
+            duplicate = !catchUp(tree, dataPath, rowSize, col, indexedRows, duplicateKey);
+        }
+    }
+    sorters.clear();
+    std::error_code ec;
+    fs::remove_all(tmpDir, ec);
+
+    if (!built) {
+        fs::remove(idxPath, ec);
+        std::cout << "Index build failed for field '" << field << "'.\n";
+        return false;
+    }
+    if (duplicate) {
+        fs::remove(idxPath, ec);
+        std::cout << "Duplicate key '" << duplicateKey << "' for field '" << field << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+void IndexBuilder::createIndex(const std::string& tableName) {
+    const std::string tablePath = "Tables/" + tableName;
+    Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+
+    std::cout << "Enter field to index: ";
+    std::string field;
+    std::getline(std::cin, field);
+    field = Utils::trim(field);
+
+    const auto uniqueKeys = schema.getUniqueKeys();
+    const int col = schema.fieldIndex(field);
+    if (col < 0) {
+        std::cout << "Field not in schema\n"; return;
+    }
+    if (std::find(uniqueKeys.begin(), uniqueKeys.end(), field) != uniqueKeys.end()) {
+        std::cout << "Field '" << field << "' is already indexed.\n"; return;
+    }
+    const int rowSize = schema.rowSize();
+    const std::string dataPath = tablePath + "/data.tbl";
+    const std::string idxPath = tablePath + "/" + field + ".idx";
+
+    // build beside the live files; nothing visible changes until the renames
+    std::string buildPath = idxPath + ".build";
+    long indexedRows = 0;
+    if (!buildIndex(tableName, field, dataPath, buildPath, indexedRows)) {
+        std::cout << "Index not created.\n";
+        return;
+    }
+    fs::rename(buildPath, idxPath);
+
+    Schema published = schema;
+    published.addUniqueKey(field);
+    published.saveToFile(tablePath + "/meta.txt.tmp");
+    fs::rename(tablePath + "/meta.txt.tmp", tablePath + "/meta.txt");
+
+    // writers that loaded meta.txt before the rename neither indexed nor
+    // checked their rows; take in whatever they appended since the last pass
+    std::string duplicateKey;
+    bool caughtUp;
+    {
+        BPlusTree tree(idxPath);
+        caughtUp = catchUp(tree, dataPath, rowSize, col, indexedRows, duplicateKey);
+    }
+    if (!caughtUp) {
+        schema.saveToFile(tablePath + "/meta.txt.tmp");
+        fs::rename(tablePath + "/meta.txt.tmp", tablePath + "/meta.txt");
+        std::error_code ec;
+        fs::remove(idxPath, ec);
+        std::cout << "Duplicate key '" << duplicateKey << "' for field '" << field << "'.\n";
+        std::cout << "Index not created.\n";
+        return;
+    }
+    std::cout << "Index on '" << field << "' created successfully.\n";
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+
+/// Builds a unique B+ tree index on an already populated table.
+/// data.tbl is scanned in parallel into (key, offset) pairs, which are
+/// external-sorted under a memory cap, checked for duplicates and bulk-loaded
+/// bottom-up into a side file. Rows appended meanwhile are caught up, and the
+/// finished file is renamed into place, so lookups are never blocked. Rows
+/// appended before writers see the new meta.txt are caught up once more after
+/// it is published; with no file locking, a writer that read the old meta.txt
+/// and appends after that final pass can still go unindexed.
+class IndexBuilder {
+public:
+    /// Memory cap for the sort of (key, offset) pairs
+    static constexpr size_t INDEX_BUILD_MEMORY = 64 * 1024 * 1024;
+    /// Rows each scan thread reads per batch
+    static constexpr int SCAN_BATCH_ROWS = 1024;
+
+    /// Prompt for a field and add a unique index on it to the table
+    static void createIndex(const std::string& tableName);
+
+    /// Build a unique index on `field` over the rows in dataPath into idxPath;
+    /// indexedRows receives how many leading rows it covers.
+    /// Returns false, leaving no file behind, if the field has duplicate values
+    /// or the key sort failed.
+    static bool buildIndex(const std::string& tableName, const std::string& field,
+        const std::string& dataPath, const std::string& idxPath, long& indexedRows,
+        size_t memoryBudget = INDEX_BUILD_MEMORY);
+};
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
@@ -79,3 +80,34 @@ long IndexManager::searchIndex(const std::string& fieldName,
     //std::cout << "returnin -1 " << std::endl;
     return -1;
 }
+
+std::vector<long> IndexManager::searchIndexBatch(const std::string& fieldName,
+    const std::vector<std::string>& keys) {
+    std::vector<long> result(keys.size(), -1);
+    auto it = trees.find(fieldName);
+    if (it == trees.end()) {
+        return result;
+    }
+
+    // sort (and dedupe) the keys so the tree is walked left to right once
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+        [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    std::vector<std::string> sorted;
+    std::vector<size_t> slot(keys.size());
+    for (size_t i : order) {
+        if (sorted.empty() || sorted.back() != keys[i]) {
+            sorted.push_back(keys[i]);
+        }
+        slot[i] = sorted.size() - 1;
+    }
+
+    std::vector<long> offsets;
+    it->second->searchBatch(sorted, offsets);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        result[i] = offsets[slot[i]];
+    }
+    return result;
+}
@@ -16,7 +16,10 @@ public:
     long getOffset(const std::string& fieldName, const std::string& key);
     long searchIndex(const std::string& fieldName,
         const std::string& key);
-
+    /// Look up many keys with one sorted pass over the tree.
+    /// Result[i] is the record offset for keys[i], or -1 if absent.
+    std::vector<long> searchIndexBatch(const std::string& fieldName,
+        const std::vector<std::string>& keys);
 
 
 private:
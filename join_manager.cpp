@@ -0,0 +1,259 @@
+#include "join_manager.hpp"
+#include "schema.hpp"
+#include "index_manager.hpp"
+#include "batch_reader.hpp"
+#include "row_view.hpp"
+#include "table_scan.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    struct JoinSide {
+        std::string name;
+        std::string dataPath;
+        std::vector<Schema::Field> fields;
+        std::vector<Schema::Field> labels;   // fields named "table.field" for output
+        std::vector<int> columns;            // every column, in schema order
+        std::vector<std::string> uniqueKeys;
+        int  col = -1;
+        bool indexed = false;
+        bool isLeft = false;
+        int  rowSize = 0;
+        long rowCount = 0;
+    };
+
+    bool openSide(const std::string& table, const std::string& column, bool isLeft, JoinSide& side) {
+        std::string tablePath = "Tables/" + table;
+        if (!fs::exists(tablePath + "/meta.txt")) {
+            std::cout << "Table '" << table << "' not found.\n";
+            return false;
+        }
+        Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+        side.name = table;
+        side.dataPath = tablePath + "/data.tbl";
+        side.fields = schema.getFields();
+        side.uniqueKeys = schema.getUniqueKeys();
+        side.isLeft = isLeft;
+        side.col = schema.fieldIndex(column);
+        if (side.col < 0) {
+            std::cout << "Field '" << column << "' not in schema of " << table << "\n";
+            return false;
+        }
+        side.indexed = std::find(side.uniqueKeys.begin(), side.uniqueKeys.end(), column)
+            != side.uniqueKeys.end();
+        side.rowSize = schema.rowSize();
+        side.labels = side.fields;
+        for (int i = 0; i < (int)side.labels.size(); ++i) {
+            side.labels[i].name = table + "." + side.fields[i].name;
+            side.columns.push_back(i);
+        }
+        side.rowCount = TableScan::rowCount(side.dataPath, side.rowSize);
+        return true;
+    }
+
+    std::string_view fieldValue(const char* row, int col) {
+        return RowView(row).field(col);
+    }
+
+    // Format one joined pair, always with the left table's columns first
+    void emitRow(const JoinSide& a, const char* rowA, const JoinSide& b, const char* rowB,
+        std::string& out) {
+        const JoinSide& left = a.isLeft ? a : b;
+        const JoinSide& right = a.isLeft ? b : a;
+        RowView(a.isLeft ? rowA : rowB).appendFields(out, left.labels, left.columns);
+        RowView(a.isLeft ? rowB : rowA).appendTo(out, right.labels, right.columns);
+        RowView::flushIfFull(out);
+    }
+
+    // Scan the outer table and probe the inner unique index a batch at a time
+    long indexNestedLoopJoin(const JoinSide& outer, const JoinSide& inner, std::string& out) {
+        IndexManager im(inner.name, "Tables/" + inner.name);
+        im.loadIndexes(inner.uniqueKeys);
+        const std::string& innerColumn = inner.fields[inner.col].name;
+
+        long count = 0;
+        std::ifstream data(outer.dataPath, std::ios::binary);
+        std::vector<char> batch(JoinManager::PROBE_BATCH * outer.rowSize);
+        std::vector<std::string> keys;
+        std::vector<char> innerRows;
+        while (data) {
+            data.read(batch.data(), batch.size());
+            size_t n = (size_t)data.gcount() / outer.rowSize;
+            if (n == 0) break;
+
+            keys.resize(n);
+            for (size_t i = 0; i < n; ++i)
+                keys[i].assign(fieldValue(batch.data() + i * outer.rowSize, outer.col));
+            std::vector<long> offsets = im.searchIndexBatch(innerColumn, keys);
+            BatchReader::readRows(inner.dataPath, offsets, inner.rowSize, innerRows);
+
+            for (size_t i = 0; i < n; ++i) {
+                if (offsets[i] < 0) continue;
+                emitRow(outer, batch.data() + i * outer.rowSize, inner, innerRows.data() + i * inner.rowSize, out);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    bool joinError(const std::string& what) {
+        std::cerr << "Join error: " << what << "\n";
+        return false;
+    }
+
+    // Build a hash table over buildPath and stream probePath through it.
+    // Returns false if either file cannot be read back in full.
+    bool hashJoinInMemory(const JoinSide& build, const std::string& buildPath,
+        const JoinSide& probe, const std::string& probePath, std::string& out, long& count) {
+        std::ifstream in(buildPath, std::ios::binary | std::ios::ate);
+        if (!in) return joinError("cannot open " + buildPath);
+        std::streamoff bytes = in.tellg();
+        std::vector<char> rows((size_t)std::max<std::streamoff>(bytes, 0));
+        in.seekg(0);
+        if (!in.read(rows.data(), rows.size())) return joinError("cannot read " + buildPath);
+        size_t buildRows = rows.size() / build.rowSize;
+
+        // keys point into `rows`, which outlives the table
+        std::unordered_multimap<std::string_view, size_t> table;
+        table.reserve(buildRows);
+        for (size_t r = 0; r < buildRows; ++r)
+            table.emplace(fieldValue(rows.data() + r * build.rowSize, build.col), r);
+
+        std::ifstream data(probePath, std::ios::binary);
+        if (!data) return joinError("cannot open " + probePath);
+        std::vector<char> row(probe.rowSize);
+        while (data.read(row.data(), probe.rowSize)) {
+            auto range = table.equal_range(fieldValue(row.data(), probe.col));
+            for (auto it = range.first; it != range.second; ++it) {
+                emitRow(probe, row.data(), build, rows.data() + it->second * build.rowSize, out);
+                ++count;
+            }
+        }
+        if (data.bad()) return joinError("cannot read " + probePath);
+        return true;
+    }
+
+    // Split one side into per-partition temp files by hash of the join key
+    bool partitionSide(const JoinSide& side, const std::string& prefix, size_t partitions) {
+        std::vector<std::ofstream> out;
+        for (size_t p = 0; p < partitions; ++p) {
+            std::string path = prefix + std::to_string(p) + ".tmp";
+            out.emplace_back(path, std::ios::binary);
+            if (!out.back()) return joinError("cannot create partition " + path);
+        }
+
+        std::hash<std::string_view> hasher;
+        std::ifstream data(side.dataPath, std::ios::binary);
+        if (!data) return joinError("cannot open " + side.dataPath);
+        std::vector<char> row(side.rowSize);
+        while (data.read(row.data(), side.rowSize)) {
+            size_t p = hasher(fieldValue(row.data(), side.col)) % partitions;
+            if (!out[p].write(row.data(), side.rowSize))
+                return joinError("cannot write partition of " + side.name);
+        }
+        if (data.bad()) return joinError("cannot read " + side.dataPath);
+        for (auto& f : out) {
+            f.close();
+            if (!f) return joinError("cannot write partition of " + side.name);
+        }
+        return true;
+    }
+
+    // Grace hash join: both sides spill to matching partitions, joined pairwise.
+    // Partitions live in a directory of their own under the build table, so
+    // concurrent joins never share or remove each other's files.
+    bool hashJoinPartitioned(const JoinSide& build, const JoinSide& probe, size_t partitions,
+        std::string& out, long& count) {
+        std::string tmpDir = "Tables/" + build.name + "/.join_tmp_"
+            + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        std::error_code ec;
+        fs::create_directories(tmpDir, ec);
+        bool ok = !ec || joinError("cannot create " + tmpDir);
+        ok = ok && partitionSide(build, tmpDir + "/build_", partitions)
+            && partitionSide(probe, tmpDir + "/probe_", partitions);
+
+        for (size_t p = 0; ok && p < partitions; ++p) {
+            std::string suffix = std::to_string(p) + ".tmp";
+            ok = hashJoinInMemory(build, tmpDir + "/build_" + suffix,
+                probe, tmpDir + "/probe_" + suffix, out, count);
+        }
+        fs::remove_all(tmpDir, ec);
+        return ok;
+    }
+}
+
+void JoinManager::joinTables() {
+    std::string leftTable, leftColumn, rightTable, rightColumn;
+    std::cout << "Enter left table: ";
+    std::cin >> leftTable;
+    std::cout << "Enter left join column: ";
+    std::cin >> leftColumn;
+    std::cout << "Enter right table: ";
+    std::cin >> rightTable;
+    std::cout << "Enter right join column: ";
+    std::cin >> rightColumn;
+
+    JoinSide left, right;
+    if (!openSide(leftTable, leftColumn, true, left) ||
+        !openSide(rightTable, rightColumn, false, right)) {
+        return;
+    }
+
+    // Index nested-loop join pays one probe per outer row, so it only wins
+    // when the indexed (inner) side is at least as large as the outer side.
+    const JoinSide* inner = nullptr;
+    if (left.indexed && right.indexed)
+        inner = left.rowCount >= right.rowCount ? &left : &right;
+    else if (left.indexed)
+        inner = &left;
+    else if (right.indexed)
+        inner = &right;
+
+    long count = 0;
+    std::string out;
+    if (inner) {
+        const JoinSide& outer = inner == &left ? right : left;
+        if (inner->rowCount >= outer.rowCount) {
+            std::cout << "Using index nested-loop join on "
+                << inner->name << "." << inner->fields[inner->col].name << "\n";
+            count = indexNestedLoopJoin(outer, *inner, out);
+            std::cout.write(out.data(), out.size());
+            std::cout << count << " row(s) joined.\n";
+            return;
+        }
+    }
+
+    // Hash join: build on the smaller side
+    const JoinSide& build = left.rowCount <= right.rowCount ? left : right;
+    const JoinSide& probe = &build == &left ? right : left;
+    // rows plus key copy and bucket overhead, roughly twice the raw bytes
+    size_t needed = (size_t)build.rowCount * build.rowSize * 2;
+    bool ok;
+    if (needed <= HASH_JOIN_MEMORY) {
+        std::cout << "Using hash join, building on " << build.name << "\n";
+        ok = hashJoinInMemory(build, build.dataPath, probe, probe.dataPath, out, count);
+    }
+    else {
+        size_t partitions = std::min(MAX_JOIN_PARTITIONS, needed / HASH_JOIN_MEMORY + 1);
+        std::cout << "Using partitioned hash join (" << partitions
+            << " partitions), building on " << build.name << "\n";
+        ok = hashJoinPartitioned(build, probe, partitions, out, count);
+    }
+    std::cout.write(out.data(), out.size());
+    if (!ok) {
+        std::cout << "Join failed after " << count << " row(s).\n";
+        return;
+    }
+    std::cout << count << " row(s) joined.\n";
+}
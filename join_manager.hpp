@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+/// Equi-join between two tables on one column each.
+/// Picks an index nested-loop join when a side has a unique B+ tree on its
+/// join column and is at least as large as the other side; otherwise runs a
+/// hash join, partitioning both inputs to disk when the build side would not
+/// fit in HASH_JOIN_MEMORY.
+class JoinManager {
+public:
+    /// Memory budget for the in-memory hash table of a hash join
+    static constexpr size_t HASH_JOIN_MEMORY = 64 * 1024 * 1024;
+    /// Most partitions, and so partition files open at once, per join side
+    static constexpr size_t MAX_JOIN_PARTITIONS = 256;
+    /// Outer rows probed per batched index lookup
+    static constexpr size_t PROBE_BATCH = 1024;
+
+    /// Prompt for two tables and join columns, then print matching row pairs
+    static void joinTables();
+};
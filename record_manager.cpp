@@ -1,12 +1,19 @@
 #include "record_manager.hpp"
 #include "schema.hpp"
 #include "index_manager.hpp"
+#include "batch_reader.hpp"
+#include "utils.hpp"
+#include "row_view.hpp"
+#include "cluster_manager.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <filesystem>
 #include <vector>
 #include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <string_view>
 
 void RecordManager::addRecord(const std::string& tableName) {
     // Load schema
@@ -35,14 +42,11 @@ void RecordManager::addRecord(const std::string& tableName) {
         std::string val;
         std::cin >> val;
 
-        if (f.type == "int") {
-            try {
-                std::stoi(val);
-            }
-            catch (...) {
-                std::cout << "Invalid input for int field: " << f.name << "\n";
-                return;
-            }
+        // ints are stored in one spelling only ("7", never "07" or "7abc"),
+        // so indexes comparing text and clustered keys comparing values agree
+        if (f.type == "int" && !RowView::isCanonicalInt(val)) {
+            std::cout << "Invalid input for int field: " << f.name << "\n";
+            return;
         }
         data.push_back(val);
     }
@@ -67,14 +71,15 @@ void RecordManager::addRecord(const std::string& tableName) {
 
     long offset = file.tellp();
     for (const std::string& val : data) {
-        char buffer[40] = {};
+        char buffer[Schema::FIELD_SIZE] = {};
 #ifdef _MSC_VER
-        strncpy_s(buffer, val.c_str(), 40);
+        strncpy_s(buffer, val.c_str(), Schema::FIELD_SIZE);
 #else
-        std::strncpy(buffer, val.c_str(), 40);
+        std::strncpy(buffer, val.c_str(), Schema::FIELD_SIZE);
 #endif
-        file.write(buffer, 40);
+        file.write(buffer, Schema::FIELD_SIZE);
     }
+    file.close();
 
    
     for (size_t i = 0; i < fields.size(); ++i) {
@@ -86,17 +91,16 @@ void RecordManager::addRecord(const std::string& tableName) {
 
     indexManager.saveIndexes();
     std::cout << "Record added successfully.\n";
+
+    // new rows land in the overflow tail of a clustered table
+    ClusterManager::maybeReorganize(tableName);
 }
 void RecordManager::findRecord(const std::string& tableName) {
-    // 1) load schema & unique keys
-    std::ifstream meta("Tables/" + tableName + "/meta.txt");
-    std::string schemaStr, keysStr;
-    std::getline(meta, schemaStr);
-    std::getline(meta, keysStr);
-    Schema schema(schemaStr, keysStr);
+    // 1) load schema, unique keys & cluster key
+    Schema schema = Schema::loadFromFile("Tables/" + tableName + "/meta.txt");
 
     // 2) get user query
-    std::cout << "Enter query (field=value): ";
+    std::cout << "Enter query (field=value or field=low..high): ";
     std::string input;
     std::getline(std::cin, input);
     auto eq = input.find('=');
@@ -114,25 +118,68 @@ void RecordManager::findRecord(const std::string& tableName) {
     // 3) find field index & unique flag
     const auto& fields = schema.getFields();
     const auto& uniqueKeys = schema.getUniqueKeys();
-    int idx = -1;
-    bool isUnique = false;
-    for (int i = 0; i < (int)fields.size(); ++i) {
-        if (fields[i].name == field) {
-            idx = i;
-            isUnique = std::find(uniqueKeys.begin(), uniqueKeys.end(), field)
-                != uniqueKeys.end();
-            break;
-        }
-    }
+    const int idx = schema.fieldIndex(field);
     if (idx < 0) {
         std::cout << "Field not in schema\n"; return;
     }
-    
+    const bool isUnique = std::find(uniqueKeys.begin(), uniqueKeys.end(), field)
+        != uniqueKeys.end();
+    std::vector<int> columns;
+    if (!readProjection(schema, columns)) return;
 
-    // 4) if unique: use B+ tree
-    IndexManager im(tableName, "Tables/" + tableName);
-    im.loadIndexes(uniqueKeys);
-    if (isUnique) {
+    const int rowSize = schema.rowSize();
+    std::string out;
+    out.reserve(RowView::OUTPUT_FLUSH + rowSize * 2);
+    auto emit = [&](const RowView& row) {
+        row.appendTo(out, fields, columns);
+        RowView::flushIfFull(out);
+        };
+    const bool clustered = field == schema.getClusterKey();
+    const auto dots = value.find("..");
+
+    // 4) range: sequential read of the sorted rows on a clustered key,
+    //    otherwise a scan comparing in key order
+    if (dots != std::string::npos) {
+        std::string low = value.substr(0, dots), high = value.substr(dots + 2);
+        if (clustered) {
+            ClusterManager::rangeScan(tableName, low, high, emit);
+        }
+        else {
+            std::cout << "Scanning all records...\n";
+            const bool isInt = fields[idx].type == "int";
+            char lowKey[RowView::SORT_KEY_SIZE], highKey[RowView::SORT_KEY_SIZE], key[RowView::SORT_KEY_SIZE];
+            RowView::encodeSortKey(low, isInt, lowKey);
+            RowView::encodeSortKey(high, isInt, highKey);
+            std::ifstream data("Tables/" + tableName + "/data.tbl", std::ios::binary);
+            std::vector<char> buf((size_t)SCAN_BATCH_ROWS * rowSize);
+            while (data) {
+                data.read(buf.data(), buf.size());
+                size_t n = (size_t)data.gcount() / rowSize;
+                for (size_t r = 0; r < n; ++r) {
+                    RowView row(buf.data() + r * rowSize);
+                    RowView::encodeSortKey(row.field(idx), isInt, key);
+                    if (std::memcmp(key, lowKey, sizeof(key)) < 0 ||
+                        std::memcmp(key, highKey, sizeof(key)) > 0) continue;
+                    emit(row);
+                }
+            }
+        }
+        std::cout.write(out.data(), out.size());
+        return;
+    }
+
+    // 5) clustered key: the fence names the one block to read
+    if (clustered) {
+        std::vector<char> buf;
+        if (!ClusterManager::lookup(tableName, value, buf)) {
+            std::cout << "Not found\n"; return;
+        }
+        emit(RowView(buf.data()));
+    }
+    // 6) if unique: use B+ tree
+    else if (isUnique) {
+        IndexManager im(tableName, "Tables/" + tableName);
+        im.loadIndexes(uniqueKeys);
         long off = im.searchIndex(field, value);
         if (off < 0) {
             std::cout << "Not found\n"; return;
@@ -140,30 +187,120 @@ void RecordManager::findRecord(const std::string& tableName) {
         // read exactly one record at off
         std::ifstream data("Tables/" + tableName + "/data.tbl", std::ios::binary);
         data.seekg(off);
-        for (auto& f : fields) {
-            char buf[40] = {};
-            data.read(buf, 40);
-            std::cout << f.name << ": " << buf << "  ";
-        }
-        std::cout << "\n";
+        std::vector<char> buf(rowSize);
+        data.read(buf.data(), rowSize);
+        emit(RowView(buf.data()));
     }
-    // 5) else: linear scan
+    // 7) else: linear scan over a reused batch buffer, no per-row allocation
     else {
         std::cout << "Scanning all records...\n";
         std::ifstream data("Tables/" + tableName + "/data.tbl", std::ios::binary);
-        while (data.peek() != EOF) {
-            long recPos = data.tellg();
-            std::vector<std::string> row(fields.size());
-            for (int i = 0; i < (int)fields.size(); ++i) {
-                char buf[40] = {};
-                data.read(buf, 40);
-                row[i] = buf;
+        std::vector<char> buf((size_t)SCAN_BATCH_ROWS * rowSize);
+        const std::string_view wanted(value);
+        while (data) {
+            data.read(buf.data(), buf.size());
+            size_t n = (size_t)data.gcount() / rowSize;
+            for (size_t r = 0; r < n; ++r) {
+                RowView row(buf.data() + r * rowSize);
+                if (row.field(idx) == wanted) emit(row);
+            }
+        }
+    }
+    std::cout.write(out.data(), out.size());
+}
+
+bool RecordManager::readProjection(const Schema& schema, std::vector<int>& columns) {
+    std::cout << "Enter columns to show (comma separated, blank for all): ";
+    std::string line;
+    std::getline(std::cin, line);
+
+    columns.clear();
+    for (const auto& name : Utils::split(line, ',')) {
+        if (name.empty()) continue;
+        int c = schema.fieldIndex(name);
+        if (c < 0) {
+            std::cout << "Field not in schema: " << name << "\n";
+            return false;
+        }
+        columns.push_back(c);
+    }
+    if (columns.empty()) {
+        for (int i = 0; i < (int)schema.getFields().size(); ++i) columns.push_back(i);
+    }
+    return true;
+}
+
+void RecordManager::findRecords(const std::string& tableName) {
+    // 1) load schema & unique keys
+    std::ifstream meta("Tables/" + tableName + "/meta.txt");
+    std::string schemaStr, keysStr;
+    std::getline(meta, schemaStr);
+    std::getline(meta, keysStr);
+    Schema schema(schemaStr, keysStr);
+
+    // 2) get field and the list of values to fetch
+    std::cout << "Enter field: ";
+    std::string field;
+    std::getline(std::cin, field);
+    field = Utils::trim(field);
+    std::cout << "Enter values (comma separated): ";
+    std::string line;
+    std::getline(std::cin, line);
+    std::vector<std::string> keys;
+    for (const auto& k : Utils::split(line, ',')) {
+        if (!k.empty()) keys.push_back(k);
+    }
+    if (keys.empty()) {
+        std::cout << "No values given\n"; return;
+    }
+
+    const auto& fields = schema.getFields();
+    const auto& uniqueKeys = schema.getUniqueKeys();
+    const int idx = schema.fieldIndex(field);
+    if (idx < 0) {
+        std::cout << "Field not in schema\n"; return;
+    }
+    bool isUnique = std::find(uniqueKeys.begin(), uniqueKeys.end(), field)
+        != uniqueKeys.end();
+    std::vector<int> columns;
+    if (!readProjection(schema, columns)) return;
+
+    const int rowSize = schema.rowSize();
+    const std::string dataPath = "Tables/" + tableName + "/data.tbl";
+    std::string out;
+
+    // 3) unique: one sorted pass over the B+ tree, then coalesced row reads
+    if (isUnique) {
+        IndexManager im(tableName, "Tables/" + tableName);
+        im.loadIndexes(uniqueKeys);
+        std::vector<long> offsets = im.searchIndexBatch(field, keys);
+
+        std::vector<char> rows;
+        BatchReader::readRows(dataPath, offsets, rowSize, rows);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (offsets[i] < 0) {
+                out.append("Not found: ").append(keys[i]).push_back('\n');
+                continue;
             }
-            if (row[idx] == value) {
-                for (int i = 0; i < (int)fields.size(); ++i)
-                    std::cout << fields[i].name << ": " << row[i] << "  ";
-                std::cout << "\n";
+            RowView(rows.data() + i * rowSize).appendTo(out, fields, columns);
+        }
+    }
+    // 4) else: a single scan answers every value at once
+    else {
+        std::cout << "Scanning all records...\n";
+        std::unordered_set<std::string_view> wanted(keys.begin(), keys.end());
+        std::ifstream data(dataPath, std::ios::binary);
+        std::vector<char> buf((size_t)SCAN_BATCH_ROWS * rowSize);
+        while (data) {
+            data.read(buf.data(), buf.size());
+            size_t n = (size_t)data.gcount() / rowSize;
+            for (size_t r = 0; r < n; ++r) {
+                RowView row(buf.data() + r * rowSize);
+                if (!wanted.count(row.field(idx))) continue;
+                row.appendTo(out, fields, columns);
+                RowView::flushIfFull(out);
             }
         }
     }
+    std::cout.write(out.data(), out.size());
 }
@@ -1,10 +1,19 @@
 #pragma once
 #include <string>
+#include <vector>
+#include "schema.hpp"
 
 class RecordManager {
 public:
+    /// Rows read per chunk by the scan path
+    static constexpr int SCAN_BATCH_ROWS = 256;
+
     static void addRecord(const std::string& tableName);
     static void findRecord(const std::string& tableName);
-  
+    /// Multi-get: look up many values of one field in a single batch
+    static void findRecords(const std::string& tableName);
 
+private:
+    /// Ask which columns to print; blank selects every column
+    static bool readProjection(const Schema& schema, std::vector<int>& columns);
 };
@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "schema.hpp"
+
+/// Non-owning view over one fixed-width row (40 bytes per field) inside a
+/// caller-owned read buffer. Accessors decode a single field on demand and
+/// never allocate; the view is only valid while the buffer is unchanged.
+class RowView {
+public:
+    static constexpr int FIELD_SIZE = Schema::FIELD_SIZE;
+    static constexpr int SORT_KEY_SIZE = 40;
+    /// Output built with appendTo is written out once it reaches this size
+    static constexpr size_t OUTPUT_FLUSH = 1 << 20;
+
+    RowView() = default;
+    explicit RowView(const char* data) : row(data) {}
+
+    /// Field i as text, up to its NUL terminator
+    std::string_view field(int i) const {
+        const char* p = row + i * FIELD_SIZE;
+        return std::string_view(p, strnlen(p, FIELD_SIZE));
+    }
+
+    /// Field i parsed as an integer (0 if it is not one)
+    long long asInt(int i) const {
+        std::string_view f = field(i);
+        long long v = 0;
+        std::from_chars(f.data(), f.data() + f.size(), v);
+        return v;
+    }
+
+    /// True if value is an integer in its one canonical spelling (no sign
+    /// other than '-', no leading zeros, nothing trailing), so that equal
+    /// text and equal value coincide
+    static bool isCanonicalInt(std::string_view value) {
+        long long v = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), v);
+        if (ec != std::errc() || end != value.data() + value.size()) return false;
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        return std::string_view(buf, res.ptr - buf) == value;
+    }
+
+    /// Encode a field value so that memcmp order equals value order:
+    /// ints become sign-flipped big-endian, strings are zero-padded
+    static void encodeSortKey(std::string_view value, bool isInt, char* out) {
+        std::memset(out, 0, SORT_KEY_SIZE);
+        if (isInt) {
+            long long v = 0;
+            std::from_chars(value.data(), value.data() + value.size(), v);
+            uint64_t u = static_cast<uint64_t>(v) ^ (1ULL << 63);
+            for (int i = 0; i < 8; ++i)
+                out[i] = static_cast<char>(u >> (56 - 8 * i));
+        }
+        else {
+            std::memcpy(out, value.data(), std::min<size_t>(value.size(), SORT_KEY_SIZE));
+        }
+    }
+
+    /// Append "name: value  " for each projected column
+    void appendFields(std::string& out, const std::vector<Schema::Field>& fields,
+        const std::vector<int>& columns) const {
+        for (int c : columns) {
+            out.append(fields[c].name);
+            out.append(": ");
+            out.append(field(c));
+            out.append("  ");
+        }
+    }
+
+    /// Write out to std::cout and clear it once it reaches OUTPUT_FLUSH bytes
+    static void flushIfFull(std::string& out) {
+        if (out.size() >= OUTPUT_FLUSH) {
+            std::cout.write(out.data(), out.size());
+            out.clear();
+        }
+    }
+
+    /// appendFields, then a newline
+    void appendTo(std::string& out, const std::vector<Schema::Field>& fields,
+        const std::vector<int>& columns) const {
+        appendFields(out, fields, columns);
+        out.push_back('\n');
+    }
+
+private:
+    const char* row = nullptr;
+};
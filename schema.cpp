@@ -3,7 +3,9 @@
 #include <sstream>
 #include <iostream>
 
-Schema::Schema(const std::string& schemaStr, const std::string& uniqueKeysStr) {
+Schema::Schema(const std::string& schemaStr, const std::string& uniqueKeysStr,
+    const std::string& clusterKeyStr)
+    : clusterKey(clusterKeyStr) {
     std::stringstream ss(schemaStr);
     std::string token;
 
@@ -15,7 +17,7 @@ Schema::Schema(const std::string& schemaStr, const std::string& uniqueKeysStr) {
         Field f;
         f.type = type;
         f.name = name;
-        f.length = (type == "string") ? 40 : sizeof(int); // default string size
+        f.length = (type == "string") ? FIELD_SIZE : sizeof(int); // default string size
 
         fields.push_back(f);
     }
@@ -41,6 +43,19 @@ void Schema::saveToFile(const std::string& path) {
             out << ",";
     }
     out << "\n";
+
+    // third line only exists for clustered tables
+    if (!clusterKey.empty())
+        out << clusterKey << "\n";
+}
+
+Schema Schema::loadFromFile(const std::string& path) {
+    std::ifstream in(path);
+    std::string schemaStr, keysStr, clusterStr;
+    std::getline(in, schemaStr);
+    std::getline(in, keysStr);
+    std::getline(in, clusterStr);
+    return Schema(schemaStr, keysStr, clusterStr);
 }
 
 std::vector<Schema::Field> Schema::getFields() const {
@@ -52,3 +67,26 @@ std::vector<std::string> Schema::getUniqueKeys() const {
    // for (auto e : uniqueKeys) std::cout << e << std::endl;
     return uniqueKeys;
 }
+
+int Schema::fieldIndex(const std::string& name) const {
+    for (int i = 0; i < (int)fields.size(); ++i) {
+        if (fields[i].name == name) return i;
+    }
+    return -1;
+}
+
+int Schema::rowSize() const {
+    return (int)fields.size() * FIELD_SIZE;
+}
+
+void Schema::addUniqueKey(const std::string& name) {
+    uniqueKeys.push_back(name);
+}
+
+std::string Schema::getClusterKey() const {
+    return clusterKey;
+}
+
+void Schema::setClusterKey(const std::string& name) {
+    clusterKey = name;
+}
@@ -4,18 +4,32 @@
 
 class Schema {
 public:
+    /// Every field occupies a fixed slot of this many bytes in data.tbl
+    static constexpr int FIELD_SIZE = 40;
+
     struct Field {
         std::string type;
         std::string name;
         int length;  // Only used for strings
     };
 
-    Schema(const std::string& schemaStr, const std::string& uniqueKeysStr);
+    Schema(const std::string& schemaStr, const std::string& uniqueKeysStr,
+        const std::string& clusterKeyStr = "");
     void saveToFile(const std::string& path);
+    static Schema loadFromFile(const std::string& path);
     std::vector<Field> getFields() const;
     std::vector<std::string> getUniqueKeys() const;
+    /// Position of the field called name, or -1 if there is none
+    int fieldIndex(const std::string& name) const;
+    /// Bytes per row in data.tbl
+    int rowSize() const;
+    void addUniqueKey(const std::string& name);
+    /// Field the rows are kept sorted by, or empty for a plain heap table
+    std::string getClusterKey() const;
+    void setClusterKey(const std::string& name);
 
 private:
     std::vector<Field> fields;
     std::vector<std::string> uniqueKeys;
+    std::string clusterKey;
 };
@@ -0,0 +1,178 @@
+#include "sort_manager.hpp"
+#include "schema.hpp"
+#include "bplustree.hpp"
+#include "batch_reader.hpp"
+#include "external_sort.hpp"
+#include "row_view.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int SORT_KEY_SIZE = RowView::SORT_KEY_SIZE;
+
+    // Sort key for one row; DESC inverts every byte of the ascending key
+    void encodeKey(const char* row, int col, bool isInt, bool descending, char* out) {
+        RowView::encodeSortKey(RowView(row).field(col), isInt, out);
+        if (descending) {
+            for (int i = 0; i < SORT_KEY_SIZE; ++i) out[i] = ~out[i];
+        }
+    }
+
+    bool keyLess(const char* a, const char* b) {
+        return std::memcmp(a, b, SORT_KEY_SIZE) < 0;
+    }
+
+    // Format one row into the output buffer, writing it out once it is large
+    void printRow(const std::vector<Schema::Field>& fields, const std::vector<int>& columns,
+        const char* row, std::string& out) {
+        RowView(row).appendTo(out, fields, columns);
+        RowView::flushIfFull(out);
+    }
+
+    // Call visit(row) for every row of data.tbl, reading FETCH_BATCH rows at a time
+    template <typename Visit>
+    void scanRows(const std::string& dataPath, int rowSize, Visit visit) {
+        std::ifstream data(dataPath, std::ios::binary);
+        std::vector<char> buf(SortManager::FETCH_BATCH * rowSize);
+        while (data) {
+            data.read(buf.data(), buf.size());
+            size_t n = (size_t)data.gcount() / rowSize;
+            for (size_t i = 0; i < n; ++i) visit(buf.data() + i * rowSize);
+        }
+    }
+}
+
+void SortManager::orderBy(const std::string& tableName) {
+    std::cout << "Enter ORDER BY (column [ASC|DESC] [LIMIT n] [MEMORY bytes]): ";
+    std::string line;
+    std::getline(std::cin, line);
+
+    std::stringstream ss(line);
+    std::string column, token;
+    ss >> column;
+    bool descending = false;
+    long limit = -1;
+    size_t memory = SORT_MEMORY;
+    while (ss >> token) {
+        std::transform(token.begin(), token.end(), token.begin(), ::toupper);
+        if (token == "ASC") descending = false;
+        else if (token == "DESC") descending = true;
+        else if (token == "LIMIT" && ss >> limit && limit >= 0) {}
+        else if (token == "MEMORY" && ss >> memory && memory > 0) {}
+        else {
+            std::cout << "Invalid ORDER BY clause\n";
+            return;
+        }
+    }
+    if (column.empty()) {
+        std::cout << "Invalid ORDER BY clause\n";
+        return;
+    }
+    orderBy(tableName, column, descending, limit, memory, "Tables/" + tableName + "/.sort_tmp");
+}
+
+void SortManager::orderBy(const std::string& tableName, const std::string& column,
+    bool descending, long limit, size_t memoryBudget, const std::string& tempDir) {
+    const std::string tablePath = "Tables/" + tableName;
+    const std::string dataPath = tablePath + "/data.tbl";
+    Schema schema = Schema::loadFromFile(tablePath + "/meta.txt");
+    const auto fields = schema.getFields();
+    const auto uniqueKeys = schema.getUniqueKeys();
+
+    const int col = schema.fieldIndex(column);
+    if (col < 0) {
+        std::cout << "Field not in schema\n"; return;
+    }
+    const bool isInt = fields[col].type == "int";
+    const int rowSize = schema.rowSize();
+    const size_t recordSize = SORT_KEY_SIZE + rowSize;
+    memoryBudget = std::max(memoryBudget, MIN_SORT_MEMORY);
+    if (limit == 0) return;
+    std::vector<int> columns(fields.size());
+    for (int i = 0; i < (int)columns.size(); ++i) columns[i] = i;
+    std::string out;
+
+    // 1) indexed string column, ascending: the leaf chain is already in order.
+    //    (Index keys compare as text, so int columns cannot use this path.)
+    bool indexed = std::find(uniqueKeys.begin(), uniqueKeys.end(), column) != uniqueKeys.end();
+    if (indexed && !isInt && !descending) {
+        BPlusTree tree(tablePath + "/" + column + ".idx");
+        std::vector<long> offsets;
+        std::vector<char> rows;
+        long printed = 0;
+        auto flush = [&]() {
+            BatchReader::readRows(dataPath, offsets, rowSize, rows);
+            for (size_t i = 0; i < offsets.size(); ++i) printRow(fields, columns, rows.data() + i * rowSize, out);
+            offsets.clear();
+            };
+        tree.scanInOrder([&](const char*, long offset) {
+            offsets.push_back(offset);
+            ++printed;
+            if (offsets.size() == FETCH_BATCH) flush();
+            return limit < 0 || printed < limit;
+            });
+        flush();
+        std::cout.write(out.data(), out.size());
+        return;
+    }
+
+    std::vector<char> record(recordSize);
+    auto encode = [&](const char* row) {
+        encodeKey(row, col, isInt, descending, record.data());
+        std::memcpy(record.data() + SORT_KEY_SIZE, row, rowSize);
+        };
+
+    // 2) LIMIT that fits the budget: keep the best `limit` rows in a max-heap
+    if (limit > 0 && (size_t)limit * recordSize <= memoryBudget) {
+        std::vector<char> slots((size_t)limit * recordSize);
+        std::vector<size_t> heap;
+        auto slot = [&](size_t s) { return slots.data() + s * recordSize; };
+        auto heapLess = [&](size_t a, size_t b) { return keyLess(slot(a), slot(b)); };
+        scanRows(dataPath, rowSize, [&](const char* row) {
+            encode(row);
+            if (heap.size() < (size_t)limit) {
+                std::memcpy(slot(heap.size()), record.data(), recordSize);
+                heap.push_back(heap.size());
+                std::push_heap(heap.begin(), heap.end(), heapLess);
+            }
+            else if (keyLess(record.data(), slot(heap.front()))) {
+                std::pop_heap(heap.begin(), heap.end(), heapLess);
+                std::memcpy(slot(heap.back()), record.data(), recordSize);
+                std::push_heap(heap.begin(), heap.end(), heapLess);
+            }
+            });
+        std::sort_heap(heap.begin(), heap.end(), heapLess);
+        for (size_t s : heap) printRow(fields, columns, slot(s) + SORT_KEY_SIZE, out);
+        std::cout.write(out.data(), out.size());
+        return;
+    }
+
+    // 3) everything else: run generation plus k-way merge
+    {
+        ExternalSorter sorter(recordSize, memoryBudget, tempDir, keyLess);
+        scanRows(dataPath, rowSize, [&](const char* row) {
+            encode(row);
+            sorter.add(record.data());
+            });
+        if (sorter.finish()) {
+            for (long printed = 0; (limit < 0 || printed < limit) && sorter.next(record.data()); ++printed) {
+                printRow(fields, columns, record.data() + SORT_KEY_SIZE, out);
+            }
+        }
+        std::cout.write(out.data(), out.size());
+        if (sorter.failed()) {
+            std::cout << "ORDER BY failed: could not spill or merge sort runs; output is incomplete.\n";
+        }
+    }
+    // the sorter removed its run files; drop the directory it spilled into
+    std::error_code ec;
+    fs::remove_all(tempDir, ec);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+/// ORDER BY [ASC|DESC] [LIMIT n] over one column of a table.
+/// Ascending order on an indexed string column streams straight from the
+/// B+ tree leaf chain. Otherwise a LIMIT keeps the best n rows in a bounded
+/// heap, and an unlimited sort runs an ExternalSorter that spills sorted
+/// runs to a temp directory once the memory budget is reached.
+class SortManager {
+public:
+    /// Default memory budget for heaps and sort runs
+    static constexpr size_t SORT_MEMORY = 64 * 1024 * 1024;
+    /// Smaller budgets are raised to this, so a tiny MEMORY does not turn
+    /// every few rows into a run file
+    static constexpr size_t MIN_SORT_MEMORY = 1024 * 1024;
+    /// Rows fetched per batched read when streaming from an index
+    static constexpr size_t FETCH_BATCH = 1024;
+
+    /// Prompt for "column [ASC|DESC] [LIMIT n] [MEMORY bytes]" and print rows
+    static void orderBy(const std::string& tableName);
+
+    /// Print up to `limit` rows (-1 for all) ordered by column, spilling to
+    /// tempDir when more than memoryBudget bytes (at least MIN_SORT_MEMORY)
+    /// are needed
+    static void orderBy(const std::string& tableName, const std::string& column,
+        bool descending, long limit, size_t memoryBudget, const std::string& tempDir);
+};
@@ -2,6 +2,10 @@
 #include "schema.hpp"
 #include "record_manager.hpp"
 #include "index_manager.hpp"
+#include "aggregate_engine.hpp"
+#include "index_builder.hpp"
+#include "sort_manager.hpp"
+#include "cluster_manager.hpp"
 
 #include <iostream>
 #include <filesystem>
@@ -61,7 +65,13 @@ void TableManager::useTable() {
         std::cout << "\n--- Table: " << tableName << " ---\n"
             << "1. Add Record\n"
             << "2. Find Record\n"
-            << "3. Exit\n"
+            << "3. Find Many Records\n"
+            << "4. Aggregate\n"
+            << "5. Create Index\n"
+            << "6. Order By\n"
+            << "7. Cluster Table\n"
+            << "8. Reorganize Clustered Table\n"
+            << "9. Exit\n"
             << "Enter choice: ";
         int choice;
         std::cin >> choice;
@@ -74,6 +84,25 @@ void TableManager::useTable() {
             RecordManager::findRecord(tableName);
         }
         else if (choice == 3) {
+            RecordManager::findRecords(tableName);
+        }
+        else if (choice == 4) {
+            AggregateEngine::runAggregate(tableName);
+        }
+        else if (choice == 5) {
+            IndexBuilder::createIndex(tableName);
+        }
+        else if (choice == 6) {
+            SortManager::orderBy(tableName);
+        }
+        else if (choice == 7) {
+            ClusterManager::clusterTable(tableName);
+        }
+        else if (choice == 8) {
+            if (ClusterManager::reorganize(tableName))
+                std::cout << "Table '" << tableName << "' reorganized.\n";
+        }
+        else if (choice == 9) {
             break;
         }
         else {
@@ -0,0 +1,46 @@
+#include "table_scan.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+long TableScan::rowCount(const std::string& dataPath, int rowSize) {
+    std::error_code ec;
+    auto bytes = fs::file_size(dataPath, ec);
+    return ec ? 0 : (long)(bytes / rowSize);
+}
+
+unsigned TableScan::threadsFor(long rowCount) {
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    return (unsigned)std::clamp<long>(rowCount / MIN_ROWS_PER_THREAD, 1, hw);
+}
+
+void TableScan::parallelScan(const std::string& dataPath, int rowSize, long rowCount,
+    unsigned threads, int batchRows, const BatchVisitor& visit) {
+    auto scanRange = [&](unsigned t, long firstRow, long endRow) {
+        std::ifstream data(dataPath, std::ios::binary);
+        data.seekg((std::streamoff)firstRow * rowSize);
+        std::vector<char> buf((size_t)batchRows * rowSize);
+        for (long row = firstRow; row < endRow; ) {
+            int n = (int)std::min<long>(batchRows, endRow - row);
+            data.read(buf.data(), (std::streamsize)n * rowSize);
+            n = (int)(data.gcount() / rowSize);
+            if (n == 0) break;
+            visit(t, row, buf.data(), n);
+            row += n;
+        }
+        };
+
+    std::vector<std::thread> pool;
+    long perThread = (rowCount + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        long first = t * perThread;
+        long end = std::min<long>(rowCount, first + perThread);
+        pool.emplace_back(scanRange, t, first, end);
+    }
+    for (auto& th : pool) th.join();
+}
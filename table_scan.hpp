@@ -0,0 +1,27 @@
+#pragma once
+#include <functional>
+#include <string>
+
+/// Sequential reads over a table's data.tbl. A parallel scan splits the rows
+/// into one contiguous range per thread; each thread streams its own range
+/// in batches through a private file handle.
+class TableScan {
+public:
+    /// Below this many rows per thread, extra scan threads are not worth starting
+    static constexpr long MIN_ROWS_PER_THREAD = 16 * 1024;
+
+    /// Called with the scanning thread's number, the row number of rows[0],
+    /// and n consecutive rows laid out back to back
+    using BatchVisitor = std::function<void(unsigned thread, long firstRow,
+        const char* rows, int n)>;
+
+    /// Whole rows currently in dataPath (0 if the file is missing)
+    static long rowCount(const std::string& dataPath, int rowSize);
+
+    /// Threads worth starting for rowCount rows, capped at the core count
+    static unsigned threadsFor(long rowCount);
+
+    /// Visit rows [0, rowCount) on `threads` threads, batchRows at a time
+    static void parallelScan(const std::string& dataPath, int rowSize, long rowCount,
+        unsigned threads, int batchRows, const BatchVisitor& visit);
+};